@@ -154,7 +154,8 @@ void printL( Print & outs, int32_t degE7 )
 //    FIX_MAX = (max loggingTime)/(update period) + 1;
 //
 //  For example, if the max loggingTime is 160ms, and the update period is
-//  100ms (10Hz), then FIX_MAX = 160/100 + 1 = 2.
+//  100ms (10Hz), then FIX_MAX = 160/100 + 1 = 2.  FIX_MAX must be a
+//  power of 2, so round it up (e.g., 3 becomes 4).
 //
 //  Change the FIX_MAX value, build and run the program again.  The
 //  SD log file should now contain all records, and no OVERRUN
@@ -46,6 +46,7 @@
     !defined( NMEAGPS_PARSE_GSA ) & !defined( NMEAGPS_PARSE_GSV ) & \
     !defined( NMEAGPS_PARSE_RMC ) & !defined( NMEAGPS_PARSE_VTG ) & \
     !defined( NMEAGPS_PARSE_ZDA ) & !defined( NMEAGPS_PARSE_GST ) & \
+    !defined( NMEAGPS_PARSE_GNS ) & \
     !defined( GARMINGPS_PARSE_F )
 
   #error No NMEA sentences enabled: no fix data available.
@@ -1,6 +1,25 @@
 #ifndef NMEAGPS_CFG_H
 #define NMEAGPS_CFG_H
 
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "GPSfix_cfg.h"
+
 //------------------------------------------------------
 // Enable/disable the parsing of specific sentences.
 //
@@ -10,6 +29,10 @@
 // FYI: Only RMC and ZDA contain date information.  Other
 // sentences contain time information.  Both date and time are 
 // required if you will be doing time_t-to-clock_t operations.
+//
+// GNS is the multi-GNSS version of GGA.  HDT sets the true heading
+// (GPS_FIX_TRUE_HEADING), GBS sets the RAIM error estimates
+// (GPS_FIX_LAT_ERR et al.) and DTM sets the datum (GPS_FIX_DATUM).
 
 //#define NMEAGPS_PARSE_GGA
 //#define NMEAGPS_PARSE_GLL
@@ -19,6 +42,11 @@
 #define NMEAGPS_PARSE_RMC
 //#define NMEAGPS_PARSE_VTG
 //#define NMEAGPS_PARSE_ZDA
+//#define NMEAGPS_PARSE_DTM
+//#define NMEAGPS_PARSE_GBS
+//#define NMEAGPS_PARSE_GNS
+//#define NMEAGPS_PARSE_GRS
+//#define NMEAGPS_PARSE_HDT
 
 //------------------------------------------------------
 // Select which sentence is sent *last* by your GPS device
@@ -28,6 +56,13 @@
 
 #define LAST_SENTENCE_IN_INTERVAL NMEAGPS::NMEA_RMC
 
+// NOTE: For PUBX-only, PGRM and UBX configs, use
+//          (NMEAGPS::nmea_msg_t)(NMEAGPS::NMEA_LAST_MSG+1)
+//       Otherwise, use one of the standard NMEA messages:
+//          NMEAGPS::NMEA_RMC
+//
+//    ==>  CONFIRM THIS WITH NMEAorder.INO  <==
+//
 // If the NMEA_LAST_SENTENCE_IN_INTERVAL is not chosen 
 // correctly, GPS data may be lost because the sketch
 // takes too long elsewhere when this sentence is received.
@@ -40,32 +75,7 @@
 // it.  Just select the last sentence that you have *enabled*.
 
 //------------------------------------------------------
-// Enable/Disable coherency:
-//
-// If you need each fix to contain information that is only
-// from the current update interval, you should uncomment
-// this define.  At the beginning of the next interval,
-// the accumulating fix will start out empty.  When
-// the LAST_SENTENCE_IN_INTERVAL arrives, the valid
-// fields will be coherent.
-
-//#define NMEAGPS_COHERENT
-
-// With IMPLICIT merging, fix() will be emptied when the
-// next sentence begins.
-//
-// With EXPLICIT or NO merging, the fix() was already
-// being initialized.
-//
-// If you use the fix-oriented methods available() and read(),
-// they will empty the current fix for you automatically.
-//
-// If you use the character-oriented method decode(), you should
-// empty the accumulating fix by testing and clearing the
-// 'intervalComplete' flag in the same way that available() does.
-
-//------------------------------------------------------
-// Choose how multiple sentences are merged:
+// Choose how multiple sentences are merged into a fix:
 //   1) No merging
 //        Each sentence fills out its own fix; there could be 
 //        multiple sentences per interval.
@@ -79,6 +89,7 @@
 //        any reason (e.g., a checksum error), all the values are suspect.
 //        The fix will be cleared; no members will be valid until new 
 //        sentences are received and accepted.  This uses less RAM.
+//        (See NMEAGPS_SHADOW_FIX below to keep the earlier sentences.)
 //        An interval is defined by NMEA_LAST_SENTENCE_IN_INTERVAL.
 // Uncomment zero or one:
 
@@ -88,15 +99,8 @@
 #ifdef NMEAGPS_IMPLICIT_MERGING
   #define NMEAGPS_MERGING NMEAGPS::IMPLICIT_MERGING
 
-  // When accumulating, nothing is done to the fix at the 
-  // beginning of every sentence...
-  #ifdef NMEAGPS_COHERENT
-    // ...unless COHERENT is enabled and a new interval is starting
-    #define NMEAGPS_INIT_FIX(m) \
-      if (intervalComplete()) { intervalComplete( false ); m.valid.init(); }
-  #else
-    #define NMEAGPS_INIT_FIX(m)
-  #endif
+  // Nothing is done to the fix at the beginning of every sentence...
+  #define NMEAGPS_INIT_FIX(m)
 
   // ...but we invalidate one part when it starts to get parsed.  It *may* get
   // validated when the parsing is finished.
@@ -111,8 +115,8 @@
     #define NMEAGPS_NO_MERGING
   #endif
 
-  // When NOT accumulating, invalidate the entire fix at the 
-  // beginning of every sentence
+  // When NOT accumulating (not IMPLICIT), invalidate the entire fix 
+  // at the beginning of every sentence...
   #define NMEAGPS_INIT_FIX(m) m.valid.init()
 
   // ...so the individual parts do not need to be invalidated as they are parsed
@@ -126,11 +130,30 @@
   #error Only one MERGING technique should be enabled in NMEAGPS_cfg.h!
 #endif
 
+//------------------------------------------------------
+// With IMPLICIT_MERGING, a rejected sentence clears the entire fix,
+// including the members received from earlier sentences in the same
+// interval.  Enabling this keeps a shadow copy of the fix, saved when
+// each sentence (or UBX message) header is accepted.  If the sentence
+// is rejected (e.g., a checksum error), or it is cut short by the
+// next '$', the fix is restored from the shadow copy.  Only the
+// fields of the bad sentence are lost.
+//
+// This costs one more gps_fix of RAM, and copying it at the start of
+// each sentence.
+
+//#define NMEAGPS_SHADOW_FIX
+
+#if defined(NMEAGPS_SHADOW_FIX) && !defined(NMEAGPS_IMPLICIT_MERGING)
+  #error NMEAGPS_SHADOW_FIX is only used with NMEAGPS_IMPLICIT_MERGING in NMEAGPS_cfg.h!
+#endif
+
 //------------------------------------------------------
 // Define the fix buffer size.  The NMEAGPS object will hold on to
 // this many fixes before an overrun occurs.  This can be zero,
 // but you have to be more careful about using gps.fix() structure,
 // because it will be modified as characters are received.
+// Otherwise, it must be a power of 2 (1, 2, 4, 8...).
 
 #define NMEAGPS_FIX_MAX 1
 
@@ -138,6 +161,13 @@
   #error You must define FIX_MAX >= 1 to allow EXPLICIT merging in NMEAGPS_cfg.h
 #endif
 
+//------------------------------------------------------
+// Define how fixes are dropped when the FIFO is full.
+//   true  = the oldest fix will be dropped, and the new fix will be saved.
+//   false = the new fix will be dropped, and all old fixes will be saved.
+
+#define NMEAGPS_KEEP_NEWEST_FIXES true
+
 //------------------------------------------------------
 // Enable/Disable interrupt-style processing of GPS characters
 // If you are using one of the NeoXXSerial libraries,
@@ -226,12 +256,68 @@
   #error NMEAGPS_PARSE_SATELLITES must be defined!
 #endif
 
+//------------------------------------------------------
+// Enable/disable the satellite table (see SatelliteTable.h).  Instead
+// of an array that is rebuilt every interval, the /satellites/ member
+// holds the satellites of all constellations, identified by system and
+// PRN.  GSV pages update the table in place, GSA marks the satellites
+// used in the solution, and satellites that are no longer reported
+// are aged out.  The NMEA 4.10 signal and system IDs are used when
+// present.  The table's generation counter tells when a complete
+// interval is available (see SatelliteTable.h).
+//
+// NMEAGPS_MAX_SATELLITES should be larger for multi-GNSS receivers.
+
+//#define NMEAGPS_SATELLITE_TABLE
+
+#ifdef NMEAGPS_SATELLITE_TABLE
+  //  A satellite is removed when it has not been reported for this
+  //    many intervals (1..31).  Intervals without any GSV, GSA or
+  //    UBX NAV-SVINFO do not count.
+  #define NMEAGPS_SATELLITE_MAX_AGE (3)
+
+  #if (NMEAGPS_SATELLITE_MAX_AGE < 1) | (NMEAGPS_SATELLITE_MAX_AGE > 31)
+    #error NMEAGPS_SATELLITE_MAX_AGE must be 1..31!
+  #endif
+
+  #ifndef NMEAGPS_PARSE_SATELLITE_INFO
+    #error NMEAGPS_PARSE_SATELLITE_INFO must be defined!
+  #endif
+
+  #if NMEAGPS_MAX_SATELLITES > 127
+    #error NMEAGPS_MAX_SATELLITES must be less than 128!
+  #endif
+#endif
+
 //------------------------------------------------------
 // Enable/disable gathering interface statistics:
 // CRC errors and number of sentences received
 
 //#define NMEAGPS_STATS
 
+//------------------------------------------------------
+// Enable/disable extended statistics:  ok and checksum error counts
+// for each sentence type, unrecognized sentences, characters that
+// were discarded between sentences, and a histogram of the time from
+// the start of each update interval until its fix is stored.
+//
+// This costs about 8 bytes of RAM per counted sentence type, plus
+// about 60 bytes, and one call to micros() at the beginning and end
+// of each interval.
+
+//#define NMEAGPS_EXTENDED_STATS
+
+#ifdef NMEAGPS_EXTENDED_STATS
+  // Sentence types 0..NMEAGPS_STATS_MSGS-1 are counted separately.
+  //   The standard sentences are 1..13, and derived types (e.g., PUBX)
+  //   follow them.  Other types are counted as NMEA_UNKNOWN (0).
+  #define NMEAGPS_STATS_MSGS (16)
+
+  #ifndef NMEAGPS_STATS
+    #error NMEAGPS_STATS must be defined to use NMEAGPS_EXTENDED_STATS!
+  #endif
+#endif
+
 //------------------------------------------------------
 // Configuration item for allowing derived types of NMEAGPS.
 // If you derive classes from NMEAGPS, you *must* define NMEAGPS_DERIVED_TYPES.
@@ -253,6 +339,25 @@
   #error You must define NMEAGPS_DERIVED_TYPES in NMEAGPS.h in order to parse Talker and/or Mfr IDs!
 #endif
 
+//------------------------------------------------------
+//  Becase the NMEA checksum is not very good at error detection, you can 
+//    choose to enable additional validity checks.  This trades a little more 
+//    code and execution time for more reliability.
+//
+//  Validation at the character level is a syntactic check only.  For 
+//    example, integer fields must contain characters in the range 0..9, 
+//    latitude hemisphere letters can be 'N' or 'S'.  Characters that are not 
+//    valid for a particular field will cause the entire sentence to be 
+//    rejected as an error, *regardless* of whether the checksum would pass.
+#define NMEAGPS_VALIDATE_CHARS false
+
+//  Validation at the field level is a semantic check.  For 
+//    example, latitude degrees must be in the range -90..+90.
+//    Values that are not valid for a particular field will cause the 
+//    entire sentence to be rejected as an error, *regardless* of whether the 
+//    checksum would pass.
+#define NMEAGPS_VALIDATE_FIELDS false
+
 //------------------------------------------------------
 // Some devices may omit trailing commas at the end of some 
 // sentences.  This may prevent the last field from being 
@@ -283,4 +388,107 @@
 
 //#define NMEAGPS_PARSING_SCRATCHPAD
 
+//------------------------------------------------------
+// When complete sentences are parsed from a buffer (see
+// handle( buf, len )), the time, date, latitude and longitude
+// fields can be converted 8 characters at a time, instead of one
+// character at a time.  The results are identical.
+//
+// This needs unaligned 64-bit loads, so it is only used by GCC-
+// compatible compilers on little-endian, 32- and 64-bit CPUs (not AVR).
+
+//#define NMEAGPS_SWAR_FIELDS
+
+#if defined( NMEAGPS_SWAR_FIELDS ) &                  \
+    ( defined( __AVR__ ) | !defined( __GNUC__ ) |     \
+      !defined( __BYTE_ORDER__ ) |                    \
+      (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__) )
+  #undef NMEAGPS_SWAR_FIELDS
+#endif
+
+//------------------------------------------------------
+// Enable/disable the lazy fix (see LazyFix.h).  A block of
+// characters can be passed to handle( buf, len, lazy, handler ),
+// which only checks and recognizes each sentence.  The fields are
+// converted when a lazy_fix accessor (e.g., latitudeL()) is called,
+// and the members that are never used are never converted.
+//
+// This does not use any parser RAM, and the methods are not linked
+// unless they are used.
+
+//#define NMEAGPS_LAZY_FIX
+
+//------------------------------------------------------
+// Enable/disable a run-time parse profile for each NMEAGPS instance
+// (see NMEAGPS::profile_t).  A profile selects the sentences and the
+// fix members that are parsed, the sentence that ends an update
+// interval, and the merging technique.  Everything configured in
+// this file and GPSfix_cfg.h is the upper bound: a profile can
+// only parse less.  The rest of a sentence that is not selected,
+// and the fields of members that are not selected, are skipped.
+//
+// This uses about 16 bytes of RAM per instance (more on 32-bit
+// hosts), plus a few tests per field and per sentence.
+
+//#define NMEAGPS_RUNTIME_PROFILE
+
+//------------------------------------------------------
+// Enable/disable BasicNMEAGPS<Config> (see BasicNMEAGPS.h), a parser
+// whose Config struct selects the sentences and field converters it
+// parses, and its last sentence in an interval.  This makes the two
+// hooks that read the Config virtual (once per sentence), and each
+// parser remembers the fields of the current sentence (4 bytes of
+// RAM, and one test per field).
+
+//#define NMEAGPS_BASIC_PARSER
+
+//------------------------------------------------------
+// If you need to know the exact UTC time at *any* time,
+//   not just after a fix arrives, you must calculate the
+//   offset between the Arduino micros() clock and the UTC 
+//   time in a received fix.  There are two ways to do this:
+//
+// 1) When the GPS quiet time ends and the new update interval begins.  
+//    The timestamp will be set when the first character (the '$') of 
+//    the new batch of sentences arrives from the GPS device.  This is fairly
+//    accurate, but it will be delayed from the PPS edge by the GPS device's
+//    fix calculation time (usually ~100us).  There is very little variance
+//    in this calculation time (usually < 30us), so all timestamps are 
+//    delayed by a nearly-constant amount.
+//
+//    NOTE:  At update rates higher than 1Hz, the updates may arrive with 
+//    some increasing variance.
+
+//#define NMEAGPS_TIMESTAMP_FROM_INTERVAL
+
+// 2) From the PPS pin of the GPS module.  It is up to the application 
+//    developer to decide how to capture that event.  For example, you could:
+//
+//    a) simply poll for it in loop and call UTCsecondStart(micros());
+//    b) use attachInterrupt to call a Pin Change Interrupt ISR to save 
+//       the micros() at the time of the interrupt (see NMEAGPS.h), or
+//    c) connect the PPS to an Input Capture pin.  Set the 
+//       associated TIMER frequency, calculate the elapsed time
+//       since the PPS edge, and add that to the current micros().
+
+//#define NMEAGPS_TIMESTAMP_FROM_PPS
+
+#if defined( NMEAGPS_TIMESTAMP_FROM_INTERVAL ) &   \
+    defined( NMEAGPS_TIMESTAMP_FROM_PPS )
+  #error You cannot enable both TIMESTAMP_FROM_INTERVAL and PPS in NMEAGPS_cfg.h!
+#endif
+
+//------------------------------------------------------
+// Enable/disable tracing the latency of each fix.  Each buffered fix
+// gets micros() timestamps for the first character of its interval,
+// the last sentence of its interval, and when it was stored in the
+// fix buffer.  When the fix is read, those timestamps and the read
+// time are copied to gps.trace.  trace_latency (see Streamers.h) prints
+// them as Chrome trace events.
+//
+// This costs 16 bytes of RAM per buffered fix, plus about 20 bytes,
+// and a few calls to micros() per fix.
+
+//#define NMEAGPS_TRACE_LATENCY
+
 #endif
\ No newline at end of file
@@ -1,21 +1,39 @@
 #ifndef NEOGPS_CFG
 #define NEOGPS_CFG
 
-/**
- * Enable/disable packed data structures.
- *
- * Enabling packed data structures will use two less-portable language
- * features of GCC to reduce RAM requirements.  Although it was expected to slightly increase execution time and code size, the reverse is true on 8-bit AVRs: the code is smaller and faster with packing enabled.
- *
- * Disabling packed data structures will be very portable to other
- * platforms.  NeoGPS configurations will use slightly more RAM, and on
- * 8-bit AVRs, the speed is slightly slower, and the code is slightly
- * larger.  There may be no choice but to disable packing on processors 
- * that do not support packed structures.
- *
- * There may also be compiler-specific switches that affect packing and the
- * code which accesses packed members.  YMMV.
- **/
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+//------------------------------------------------------------------------
+// Enable/disable packed data structures.
+//
+// Enabling packed data structures will use two less-portable language
+// features of GCC to reduce RAM requirements.  Although it was expected to slightly increase execution time and code size, the reverse is true on 8-bit AVRs: the code is smaller and faster with packing enabled.
+//
+// Disabling packed data structures will be very portable to other
+// platforms.  NeoGPS configurations will use slightly more RAM, and on
+// 8-bit AVRs, the speed is slightly slower, and the code is slightly
+// larger.  There may be no choice but to disable packing on processors 
+// that do not support packed structures.
+//
+// There may also be compiler-specific switches that affect packing and the
+// code which accesses packed members.  YMMV.
+
+#include <Arduino.h>
 
 #ifdef __AVR__
   #define NEOGPS_PACKED_DATA
@@ -44,35 +62,55 @@
 
 #endif
 
-/*
- *  Accommodate C++ compiler and IDE changes.
- *
- *  Declaring constants as class data instead of instance data helps avoid
- *  collisions with #define names, and allows the compiler to perform more
- *  checks on their usage.
- *
- *  Until C++ 10 and IDE 1.6.8, initialized class data constants 
- *  were declared like this:
- *
- *      static const <valued types> = <constant-value>;
- *
- *  Now, non-simple types (e.g., float) must be declared as
- *
- *      static constexpr <nonsimple-types> = <expression-treated-as-const>;
- *
- *  The good news is that this allows the compiler to optimize out an
- *  expression that is "promised" to be "evaluatable" as a constant.
- *  The bad news is that it introduces a new language keyword, and the old
- *  code raises an error.
- *
- *  TODO: Evaluate the requirement for the "static" keyword.
- *  TODO: Evaluate using a C++ version preprocessor symbol for the #if.
- *
- *  The CONST_CLASS_DATA define will expand to the appropriate keywords.
- *
- */
-
-#if ARDUINO < 10606
+//------------------------------------------------------------------------
+// The fix buffer is a single-producer, single-consumer ring (see
+// NMEAGPSprivate.h).  On a host or a multi-core MCU, the parser and the
+// reader may be different threads, so the ring indices are accessed with
+// the GCC atomic builtins.  On other MCUs, the parser is either loop() or
+// an ISR, so volatile access and disabling interrupts are sufficient.
+
+#if defined(__GCC_ATOMIC_CHAR_LOCK_FREE) && \
+    (__GCC_ATOMIC_CHAR_LOCK_FREE == 2)   && \
+    !defined(__AVR__)
+  #define NEOGPS_ATOMIC_INDICES
+#endif
+
+//------------------------------------------------------------------------
+//  Accommodate C++ compiler and IDE changes.
+//
+//  Declaring constants as class data instead of instance data helps avoid
+//  collisions with #define names, and allows the compiler to perform more
+//  checks on their usage.
+//
+//  Until C++ 10 and IDE 1.6.8, initialized class data constants 
+//  were declared like this:
+//
+//      static const <valued types> = <constant-value>;
+//
+//  Now, non-simple types (e.g., float) must be declared as
+//
+//      static constexpr <nonsimple-types> = <expression-treated-as-const>;
+//
+//  The good news is that this allows the compiler to optimize out an
+//  expression that is "promised" to be "evaluatable" as a constant.
+//  The bad news is that it introduces a new language keyword, and the old
+//  code raises an error.
+//
+//  TODO: Evaluate the requirement for the "static" keyword.
+//  TODO: Evaluate using a C++ version preprocessor symbol for the #if.
+//          #if __cplusplus >= 201103L  (from XBee.h)
+//
+//  The CONST_CLASS_DATA define will expand to the appropriate keywords.
+//
+
+
+#if (                                              \
+      (ARDUINO < 10606)                          | \
+     ((10700  <= ARDUINO) & (ARDUINO <= 10799 )) | \
+     ((107000 <= ARDUINO) & (ARDUINO <= 107999))   \
+    )                                              \
+        &                                          \
+    !defined(ESP8266)  // PlatformIO Pull Request #82
 
   #define CONST_CLASS_DATA static const
   
@@ -82,4 +120,29 @@
   
 #endif
 
+//------------------------------------------------------------------------
+// The PROGMEM definitions are not correct for Zero, MKR1000 and
+//    earlier versions of Teensy boards
+
+#if defined(ARDUINO_SAMD_MKRZERO) | \
+    defined(ARDUINO_SAMD_ZERO)    | \
+    defined(ARDUINO_SAM_DUE)      | \
+    defined(ARDUINO_ARCH_ARC32)   | \
+    defined(__TC27XX__)           | \
+    (defined(TEENSYDUINO) && (TEENSYDUINO < 139))
+  #undef pgm_read_ptr
+  #define pgm_read_ptr(addr) (*(const void **)(addr))
+#endif
+
+
+//------------------------------------------------------------------------
+// Location_t distance, bearing and offset are normally calculated with
+//    float math (Location.cpp).  Enable this to calculate them with
+//    64-bit integers instead (LocationFixed.cpp).  These versions do not
+//    use the float math library, and they are more accurate, especially
+//    for short distances.  The results are still returned as float
+//    radians.  See Location.md.
+
+//#define NEOGPS_FIXED_POINT_LOCATION
+
 #endif
@@ -0,0 +1,63 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "HostPrint.h"
+
+using NeoGPS::BufferPrint;
+
+//----------------------------------------------------------------
+
+BufferPrint::BufferPrint( char *buf, size_t size )
+  : m_buf( buf ),
+    m_size( size )
+{
+  clear();
+}
+
+void BufferPrint::clear()
+{
+  m_len        = 0;
+  m_overflowed = false;
+  if (m_size > 0)
+    m_buf[0] = '\0';
+
+} // clear
+
+//----------------------------------------------------------------
+
+size_t BufferPrint::write( uint8_t c )
+{
+  return write( &c, 1 );
+}
+
+size_t BufferPrint::write( const uint8_t *buf, size_t len )
+{
+  //  Leave room for the NUL terminator.
+  size_t room = (m_size > m_len) ? m_size - m_len - 1 : 0;
+  if (len > room) {
+    len          = room;
+    m_overflowed = true;
+  }
+
+  memcpy( &m_buf[ m_len ], buf, len );
+  m_len += len;
+  if (m_size > 0)
+    m_buf[ m_len ] = '\0';
+
+  return len;
+
+} // write
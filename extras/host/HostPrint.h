@@ -0,0 +1,83 @@
+#ifndef HOSTPRINT_H
+#define HOSTPRINT_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+
+#include "Arduino.h"
+
+namespace NeoGPS {
+
+//------------------------------------------------------
+//
+// Print destinations for host programs.  These are host-only code.
+//
+// A FilePrint writes to a stdio FILE *, like stdout or a log file:
+//
+//    NeoGPS::FilePrint out( stdout );
+//    trace_all( out, gps, fix );
+//
+// A BufferPrint writes to a caller's char array, and keeps it
+// NUL-terminated.  Characters that do not fit are discarded, and
+// /overflowed/ returns true.
+
+class FilePrint : public Print
+{
+public:
+  FilePrint( FILE *file ) : m_file( file ) {};
+
+  size_t write( uint8_t c )
+    { return (fputc( c, m_file ) == EOF) ? 0 : 1; };
+  size_t write( const uint8_t *buf, size_t len )
+    { return fwrite( buf, 1, len, m_file ); };
+  void   flush() { fflush( m_file ); };
+  using Print::write;
+
+  FILE *file() const { return m_file; };
+
+private:
+  FILE *m_file;
+};
+
+//------------------------------------------------------
+
+class BufferPrint : public Print
+{
+public:
+  BufferPrint( char *buf, size_t size );
+
+  size_t write( uint8_t c );
+  size_t write( const uint8_t *buf, size_t len );
+  using Print::write;
+
+  const char *c_str     () const { return m_buf; };
+        size_t length   () const { return m_len; };
+        bool   overflowed() const { return m_overflowed; };
+        void   clear();
+
+private:
+  char  *m_buf;
+  size_t m_size;
+  size_t m_len;
+  bool   m_overflowed;
+};
+
+} // namespace NeoGPS
+
+#endif
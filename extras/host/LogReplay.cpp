@@ -0,0 +1,312 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "LogReplay.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+using NeoGPS::LogReplay;
+
+const size_t LogReplay::MIN_CHUNK;
+const size_t LogReplay::MAX_CHUNK;
+
+//----------------------------------------------------------------
+
+struct LogReplay::chunk_t
+{
+  size_t               begin;
+  size_t               end;
+  std::vector<gps_fix> fixes;
+
+  #ifdef NMEAGPS_STATS
+    NMEAGPS::statistics_t statistics;
+  #endif
+};
+
+//----------------------------------------------------------------
+
+LogReplay::LogReplay( factory_t factory, void *context )
+  : m_factory( factory ),
+    m_context( context ),
+    m_data( (const uint8_t *) NULL ),
+    m_size( 0 ),
+    m_fd( -1 )
+{
+  #ifdef NMEAGPS_STATS
+    m_statistics.init();
+  #endif
+}
+
+LogReplay::~LogReplay()
+{
+  close();
+}
+
+//----------------------------------------------------------------
+
+bool LogReplay::open( const char *filename )
+{
+  close();
+
+  int fd = ::open( filename, O_RDONLY );
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat( fd, &st ) < 0) {
+    ::close( fd );
+    return false;
+  }
+
+  if (st.st_size > 0) {
+    void *map = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if (map == MAP_FAILED) {
+      ::close( fd );
+      return false;
+    }
+    madvise( map, st.st_size, MADV_SEQUENTIAL );
+
+    m_data = (const uint8_t *) map;
+    m_size = st.st_size;
+  }
+  m_fd = fd;
+
+  return true;
+
+} // open
+
+//----------------------------------------------------------------
+
+void LogReplay::close()
+{
+  if (m_data)
+    munmap( (void *) m_data, m_size );
+  if (m_fd >= 0)
+    ::close( m_fd );
+
+  m_data = (const uint8_t *) NULL;
+  m_size = 0;
+  m_fd   = -1;
+
+} // close
+
+//----------------------------------------------------------------
+
+NMEAGPS *LogReplay::newParser()
+{
+  if (m_factory)
+    return m_factory( m_context );
+  return new NMEAGPS;
+
+} // newParser
+
+//----------------------------------------------------------------
+
+size_t LogReplay::syncPoint( const uint8_t *buf, size_t len, size_t pos )
+{
+  for (; pos < len; pos++) {
+    if (buf[pos] == '$')
+      break;
+    if ((buf[pos] == 0xB5) && (pos+1 < len) && (buf[pos+1] == 0x62))
+      break;
+  }
+
+  return pos;
+
+} // syncPoint
+
+//----------------------------------------------------------------
+//  Find the end of the first update interval after /pos/.
+
+size_t LogReplay::probe( const uint8_t *buf, size_t len, size_t pos )
+{
+  NMEAGPS *gps = newParser();
+
+  pos = syncPoint( buf, len, pos );
+  while (pos < len) {
+    //  A fix becomes available when an interval is complete (or after
+    //    every sentence, if merging is disabled).
+    if ((gps->handle( buf[ pos++ ] ) == NMEAGPS::DECODE_COMPLETED) &&
+        gps->available())
+      break;
+  }
+
+  delete gps;
+
+  return pos;
+
+} // probe
+
+//----------------------------------------------------------------
+//  Counts the fixes passed to a handler.
+
+struct counter_t
+{
+  NMEAGPS::fix_handler_t handler;
+  void                  *context;
+  size_t                 count;
+
+  static void onFix( const gps_fix & fix, void *context )
+    {
+      counter_t *c = (counter_t *) context;
+      c->count++;
+      if (c->handler)
+        c->handler( fix, c->context );
+    }
+};
+
+//----------------------------------------------------------------
+
+static void saveFix( const gps_fix & fix, void *context )
+{
+  ((std::vector<gps_fix> *) context)->push_back( fix );
+}
+
+void LogReplay::parse( const uint8_t *buf, chunk_t & chunk )
+{
+  NMEAGPS *gps = newParser();
+
+  gps->handle( &buf[ chunk.begin ], chunk.end - chunk.begin,
+               saveFix, &chunk.fixes );
+
+  #ifdef NMEAGPS_STATS
+    chunk.statistics = gps->statistics;
+  #endif
+
+  delete gps;
+
+} // parse
+
+//----------------------------------------------------------------
+
+size_t LogReplay::replay
+  ( const uint8_t *buf, size_t len,
+    NMEAGPS::fix_handler_t handler, void *handlerContext,
+    size_t threads )
+{
+  #ifdef NMEAGPS_STATS
+    m_statistics.init();
+  #endif
+
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+
+  //  With implicit merging, a fix can have members from any earlier
+  //    interval, so the chunks cannot be parsed separately.
+  #ifdef NMEAGPS_IMPLICIT_MERGING
+    threads = 1;
+  #endif
+
+  size_t chunkSize = len / threads;
+  if (chunkSize < MIN_CHUNK)
+    chunkSize = MIN_CHUNK;
+  else if (chunkSize > MAX_CHUNK)
+    chunkSize = MAX_CHUNK;
+
+  size_t fixes = 0;
+
+  if ((threads == 1) || (len <= chunkSize)) {
+    // Just one chunk, no need to save the fixes.
+
+    NMEAGPS  *gps     = newParser();
+    counter_t counter = { handler, handlerContext, 0 };
+
+    gps->handle( buf, len, counter_t::onFix, &counter );
+
+    #ifdef NMEAGPS_STATS
+      m_statistics = gps->statistics;
+    #endif
+    delete gps;
+
+    return counter.count;
+  }
+
+  //  Parse one batch of chunks (one per thread) at a time, so the
+  //    saved fixes do not take too much memory.
+
+  std::vector<chunk_t>     chunks( threads );
+  std::vector<size_t>      bounds( threads+1 );
+  std::vector<std::thread> workers;
+
+  size_t begin = 0;
+  while (begin < len) {
+
+    // Find the interval boundary after each nominal split.
+    bounds[0] = begin;
+    workers.clear();
+    for (size_t i=1; i <= threads; i++) {
+      size_t split = begin + i * chunkSize;
+      if (split >= len)
+        bounds[i] = len;
+      else
+        workers.push_back
+          ( std::thread
+            ( [this, buf, len, split, &bounds, i]()
+                { bounds[i] = probe( buf, len, split ); } ) );
+    }
+    for (size_t w=0; w < workers.size(); w++)
+      workers[w].join();
+
+    for (size_t i=1; i <= threads; i++)
+      if (bounds[i] < bounds[i-1])
+        bounds[i] = bounds[i-1];
+
+    // Parse each chunk with its own parser.
+    workers.clear();
+    for (size_t i=0; i < threads; i++) {
+      chunk_t & chunk = chunks[i];
+      chunk.begin = bounds[i];
+      chunk.end   = bounds[i+1];
+      chunk.fixes.clear();
+      #ifdef NMEAGPS_STATS
+        chunk.statistics.init();
+      #endif
+      if (chunk.begin < chunk.end)
+        workers.push_back
+          ( std::thread( &LogReplay::parse, this, buf, std::ref( chunk ) ) );
+    }
+    for (size_t w=0; w < workers.size(); w++)
+      workers[w].join();
+
+    // Stitch them back together, in order.
+    for (size_t i=0; i < threads; i++) {
+      chunk_t & chunk = chunks[i];
+      if (handler)
+        for (size_t f=0; f < chunk.fixes.size(); f++)
+          handler( chunk.fixes[f], handlerContext );
+      fixes += chunk.fixes.size();
+      #ifdef NMEAGPS_STATS
+        m_statistics += chunk.statistics;
+      #endif
+    }
+
+    begin = bounds[ threads ];
+  }
+
+  return fixes;
+
+} // replay
@@ -0,0 +1,123 @@
+#ifndef LOGREPLAY_H
+#define LOGREPLAY_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NMEAGPS.h"
+
+namespace NeoGPS {
+
+//------------------------------------------------------
+//
+// Replays a recorded NMEA/UBX log on several threads.
+// This is host-only code: it requires C++11 threads and mmap.
+//
+// The log is split into chunks that are parsed in parallel, each by a
+// new parser from the /factory/ (an NMEAGPS by default, or any derived
+// class like ubloxGPS).  The fixes are then passed to the /handler/ in
+// their original order, on the calling thread.
+//
+// Each nominal split point is first moved to the next sync point (a '$'
+// or the UBX sync bytes 0xB5 0x62).  A probe parser then reads from
+// there until the first fix is completed, which is the end of an update
+// interval (see LAST_SENTENCE_IN_INTERVAL in NMEAGPS_cfg.h).  Chunks
+// start at these interval boundaries, so with EXPLICIT (or no) merging,
+// the sentences of an interval are always merged by the same parser,
+// just like a sequential replay.  (Unless an interval is longer than a
+// chunk, which is at least MIN_CHUNK bytes.)  Only the valid members
+// are always the same: the invalid members of a fix may have stale
+// values from earlier sentences.
+//
+// With NMEAGPS_IMPLICIT_MERGING, a fix keeps the members of earlier
+// intervals until they are received again, so it depends on everything
+// before it.  The log is always replayed on one thread.
+//
+// Chunks are parsed in batches, one chunk per thread, so the saved
+// fixes do not use too much memory.
+
+class LogReplay
+{
+  LogReplay & operator =( const LogReplay & );
+  LogReplay( const LogReplay & );
+
+public:
+
+  //  Must return a new parser, which will be deleted by LogReplay.
+  typedef NMEAGPS *(*factory_t)( void *context );
+
+  LogReplay( factory_t factory = (factory_t) NULL, void *context = NULL );
+  ~LogReplay();
+
+  //.......................................................................
+  //  Memory-map a log file.  Returns false if it could not be opened
+  //    (see errno).
+
+  bool open( const char *filename );
+  void close();
+
+  const uint8_t *data() const { return m_data; };
+        size_t   size() const { return m_size; };
+
+  //.......................................................................
+  //  Parse the mapped file, or a buffer, and pass each fix to the
+  //    /handler/, in order.  Returns the number of fixes.  If /threads/
+  //    is 0, all cores are used.
+
+  size_t replay( NMEAGPS::fix_handler_t handler, void *handlerContext,
+                 size_t threads = 0 )
+    { return replay( m_data, m_size, handler, handlerContext, threads ); };
+
+  size_t replay( const uint8_t *buf, size_t len,
+                 NMEAGPS::fix_handler_t handler, void *handlerContext,
+                 size_t threads = 0 );
+
+  #ifdef NMEAGPS_STATS
+    //  The sum of all the chunk parsers' statistics, from the last replay.
+    const NMEAGPS::statistics_t & statistics() const { return m_statistics; };
+  #endif
+
+  //  Chunk sizes are kept in this range, regardless of the thread count.
+  static const size_t MIN_CHUNK = 64 * 1024UL;
+  static const size_t MAX_CHUNK = 16 * 1024UL * 1024UL;
+
+  //  Find the next '$' or UBX sync at or after /pos/.
+  static size_t syncPoint( const uint8_t *buf, size_t len, size_t pos );
+
+private:
+
+  factory_t  m_factory;
+  void      *m_context;
+
+  const uint8_t *m_data;
+  size_t         m_size;
+  int            m_fd;
+
+  #ifdef NMEAGPS_STATS
+    NMEAGPS::statistics_t m_statistics;
+  #endif
+
+  struct chunk_t;
+
+  NMEAGPS *newParser();
+  size_t   probe( const uint8_t *buf, size_t len, size_t pos );
+  void     parse( const uint8_t *buf, chunk_t & chunk );
+};
+
+} // namespace NeoGPS
+
+#endif
@@ -0,0 +1,273 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MappedStream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using NeoGPS::MappedStream;
+
+//----------------------------------------------------------------
+
+MappedStream::MappedStream( size_t bufferSize )
+  : m_fd( -1 ),
+    m_mapped( false ),
+    m_eof( true ),
+    m_map( (const uint8_t *) NULL ),
+    m_mapSize( 0 ),
+    m_buffer( (uint8_t *) NULL ),
+    m_bufferSize( bufferSize ? bufferSize : 1 ),
+    m_begin( 0 ),
+    m_end( 0 )
+{
+}
+
+MappedStream::~MappedStream()
+{
+  close();
+  delete [] m_buffer;
+}
+
+//----------------------------------------------------------------
+
+bool MappedStream::open( const char *filename )
+{
+  //  Open a device for writing too, so commands can be sent to the
+  //    receiver.  A FIFO is only opened for reading, or the end of the
+  //    data would never be seen.  O_NONBLOCK keeps a FIFO open from
+  //    waiting for a writer.
+  struct stat st;
+  bool fifo = (stat( filename, &st ) == 0) && S_ISFIFO( st.st_mode );
+
+  int fd = -1;
+  if (!fifo)
+    fd = ::open( filename, O_RDWR | O_NOCTTY | O_NONBLOCK );
+  if (fd < 0)
+    fd = ::open( filename, O_RDONLY | O_NOCTTY | O_NONBLOCK );
+  if (fd < 0)
+    return false;
+
+  return open( fd );
+
+} // open
+
+//----------------------------------------------------------------
+
+bool MappedStream::open( int fd )
+{
+  close();
+
+  struct stat st;
+  if (fstat( fd, &st ) < 0) {
+    ::close( fd );
+    return false;
+  }
+
+  m_fd  = fd;
+  m_eof = false;
+
+  if (S_ISREG( st.st_mode )) {
+    // Map the whole file
+    if (st.st_size > 0) {
+      void *map = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if (map == MAP_FAILED) {
+        close();
+        return false;
+      }
+      madvise( map, st.st_size, MADV_SEQUENTIAL );
+      m_map     = (const uint8_t *) map;
+      m_mapSize = st.st_size;
+    }
+    m_mapped = true;
+    m_end    = m_mapSize;
+    m_eof    = true; // nothing more to read
+
+  } else {
+    if (!m_buffer)
+      m_buffer = new uint8_t[ m_bufferSize ];
+    m_map = m_buffer;
+  }
+
+  return true;
+
+} // open
+
+//----------------------------------------------------------------
+
+void MappedStream::close()
+{
+  if (m_mapped && m_map)
+    munmap( (void *) m_map, m_mapSize );
+  if (m_fd >= 0)
+    ::close( m_fd );
+
+  m_fd      = -1;
+  m_mapped  = false;
+  m_eof     = true;
+  m_map     = (const uint8_t *) NULL;
+  m_mapSize = 0;
+  m_begin   = 0;
+  m_end     = 0;
+
+} // close
+
+//----------------------------------------------------------------
+//  Read as many bytes as are ready, without blocking.  Returns true
+//    if any were read.
+
+bool MappedStream::fill()
+{
+  if (m_eof || m_mapped || (m_fd < 0))
+    return false;
+
+  // Move the unread bytes to the front, so spans stay contiguous.
+  if (m_begin > 0) {
+    memmove( m_buffer, &m_buffer[ m_begin ], m_end - m_begin );
+    m_end  -= m_begin;
+    m_begin = 0;
+  }
+  if (m_end == m_bufferSize)
+    return false;
+
+  struct pollfd pfd;
+  pfd.fd      = m_fd;
+  pfd.events  = POLLIN;
+  pfd.revents = 0;
+  if (poll( &pfd, 1, 0 ) <= 0)
+    return false;
+
+  ssize_t n = ::read( m_fd, &m_buffer[ m_end ], m_bufferSize - m_end );
+  if (n > 0) {
+    m_end += n;
+    return true;
+  }
+
+  if ((n == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+    m_eof = true; // the writer is gone
+
+  return false;
+
+} // fill
+
+//----------------------------------------------------------------
+
+int MappedStream::available()
+{
+  if (m_begin == m_end)
+    fill();
+
+  size_t n = m_end - m_begin;
+  return (n > INT_MAX) ? INT_MAX : (int) n;
+
+} // available
+
+int MappedStream::read()
+{
+  if ((m_begin == m_end) && !fill())
+    return -1;
+
+  return m_map[ m_begin++ ];
+
+} // read
+
+int MappedStream::peek()
+{
+  if ((m_begin == m_end) && !fill())
+    return -1;
+
+  return m_map[ m_begin ];
+
+} // peek
+
+//----------------------------------------------------------------
+
+size_t MappedStream::write( uint8_t c )
+{
+  return write( &c, 1 );
+}
+
+size_t MappedStream::write( const uint8_t *buf, size_t len )
+{
+  if (m_fd < 0)
+    return 0;
+
+  size_t sent = 0;
+  while (sent < len) {
+    ssize_t n = ::write( m_fd, &buf[ sent ], len - sent );
+    if (n > 0)
+      sent += n;
+    else if ((n < 0) && (errno == EINTR))
+      continue;
+    else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+      struct pollfd pfd;
+      pfd.fd      = m_fd;
+      pfd.events  = POLLOUT;
+      pfd.revents = 0;
+      poll( &pfd, 1, -1 );
+    } else
+      break;
+  }
+
+  return sent;
+
+} // write
+
+//----------------------------------------------------------------
+
+size_t MappedStream::span( const uint8_t * & data )
+{
+  if (m_begin == m_end)
+    fill();
+
+  data = &m_map[ m_begin ];
+  return m_end - m_begin;
+
+} // span
+
+void MappedStream::consume( size_t n )
+{
+  if (n > m_end - m_begin)
+    n = m_end - m_begin;
+  m_begin += n;
+
+} // consume
+
+//----------------------------------------------------------------
+
+uint8_t MappedStream::available( NMEAGPS & gps )
+{
+  //  Like NMEAGPS::available( Stream & ), return as soon as a fix is
+  //    available, so that the caller reads the fixes in order.
+  while ((gps.processing_style == NMEAGPS::PS_POLLING) && !gps.available()) {
+    const uint8_t *data;
+    size_t         len = span( data );
+    if (len == 0)
+      break;
+
+    consume( gps.handle( data, len ) );
+  }
+
+  return gps.available();
+
+} // available
@@ -0,0 +1,112 @@
+#ifndef MAPPEDSTREAM_H
+#define MAPPEDSTREAM_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NMEAGPS.h"
+
+namespace NeoGPS {
+
+//------------------------------------------------------
+//
+// A Stream for reading GPS data from a file, a pipe or a pty.
+// This is host-only code: it requires POSIX file descriptors.
+//
+// A regular file is memory-mapped.  Anything else (a FIFO, a pty or a
+// serial device) is read into a large buffer, as many bytes at a time
+// as are ready.  The reads never block.
+//
+// The Stream methods work as usual, so existing sketch code can read
+// one character at a time.  To avoid a virtual call per character,
+// the readable bytes can be examined in place with /span/ and removed
+// with /consume/.  /available( gps )/ uses these to pass whole spans
+// to the bulk NMEAGPS::handle:
+//
+//    while (stream.available( gps )) {
+//      gps_fix fix = gps.read();
+//      ...
+//    }
+
+class MappedStream : public Stream
+{
+  MappedStream & operator =( const MappedStream & );
+  MappedStream( const MappedStream & );
+
+public:
+
+  MappedStream( size_t bufferSize = 65536 );
+  ~MappedStream();
+
+  //.......................................................................
+  //  Open a file, FIFO or device, or use an open file descriptor.
+  //    Returns false if it could not be opened or mapped (see errno).
+  //    The descriptor is closed by /close/.
+
+  bool open( const char *filename );
+  bool open( int fd );
+  void close();
+
+  //  True when a file has been completely read, or the writer closed
+  //    the pipe.
+  bool eof() const { return m_eof && (m_begin == m_end); };
+
+  //.......................................................................
+  //  Stream and Print methods.  Characters written are sent to the
+  //    device (e.g., configuration commands for a receiver on a pty).
+
+  int    available();
+  int    read();
+  int    peek();
+  size_t write( uint8_t c );
+  size_t write( const uint8_t *buf, size_t len );
+  void   flush() {};
+  using Print::write;
+
+  //.......................................................................
+  //  Contiguous access.  /span/ returns the number of readable bytes at
+  //    /data/, reading more if there are none.  /consume/ removes
+  //    /n/ bytes (up to the span length) from the front.
+
+  size_t span( const uint8_t * & data );
+  void   consume( size_t n );
+
+  //.......................................................................
+  //  Handle the readable bytes with the bulk NMEAGPS::handle, and return
+  //    the number of fixes available.  Like NMEAGPS::available( Stream & ),
+  //    bytes are left in the stream when the fix buffer is full.
+
+  uint8_t available( NMEAGPS & gps );
+
+private:
+  int            m_fd;
+  bool           m_mapped;
+  bool           m_eof;
+
+  const uint8_t *m_map;      // the mapped file, or the buffer
+  size_t         m_mapSize;
+  uint8_t       *m_buffer;
+  size_t         m_bufferSize;
+  size_t         m_begin;    // readable bytes are m_map[ m_begin..m_end )
+  size_t         m_end;
+
+  bool fill();
+};
+
+} // namespace NeoGPS
+
+#endif
@@ -0,0 +1,293 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "ReceiverPool.h"
+
+#include <string.h>
+
+using NeoGPS::ReceiverPool;
+
+const size_t ReceiverPool::QUANTUM;
+
+//----------------------------------------------------------------
+
+static NMEAGPS *newNMEAGPS( size_t, void * )
+{
+  return new NMEAGPS;
+}
+
+//----------------------------------------------------------------
+
+ReceiverPool::ReceiverPool
+  ( size_t devices, size_t workers,
+    factory_t factory, void *context,
+    size_t inputSize, size_t fixQueueSize )
+  : m_generation( 0 ),
+    m_sleeping( 0 ),
+    m_stop( false ),
+    m_steals( 0 )
+{
+  if (!factory)
+    factory = newNMEAGPS;
+
+  // Round the input ring up to a power of 2, so the free-running
+  //   indices can be masked.
+  size_t size = 64;
+  while (size < inputSize)
+    size <<= 1;
+
+  for (size_t d=0; d < devices; d++) {
+    device_t *dev = new device_t;
+    dev->gps          = factory( d, context );
+    dev->input.resize( size );
+    dev->head         = 0;
+    dev->tail         = 0;
+    dev->busy         = false;
+    dev->fixQueueSize = fixQueueSize;
+    dev->overruns     = 0;
+    m_devices.push_back( dev );
+  }
+
+  if (workers == 0)
+    workers = std::thread::hardware_concurrency();
+  if (workers == 0)
+    workers = 1;
+  if ((devices > 0) && (workers > devices))
+    workers = devices;
+
+  m_workerCount = workers;
+  m_workers.reserve( workers );
+  for (size_t w=0; w < workers; w++)
+    m_workers.push_back( std::thread( &ReceiverPool::run, this, w ) );
+
+} // constructor
+
+//----------------------------------------------------------------
+
+ReceiverPool::~ReceiverPool()
+{
+  {
+    std::lock_guard<std::mutex> lock( m_wakeLock );
+    m_stop = true;
+  }
+  m_wake.notify_all();
+
+  for (size_t w=0; w < m_workers.size(); w++)
+    m_workers[w].join();
+
+  for (size_t d=0; d < m_devices.size(); d++) {
+    delete m_devices[d]->gps;
+    delete m_devices[d];
+  }
+
+} // destructor
+
+//----------------------------------------------------------------
+
+size_t ReceiverPool::ingest( size_t device, const uint8_t *buf, size_t len )
+{
+  device_t     &dev  = *m_devices[ device ];
+  const size_t  size = dev.input.size();
+  const size_t  mask = size-1;
+
+  size_t head = dev.head.load( std::memory_order_relaxed );
+  size_t tail = dev.tail.load( std::memory_order_acquire );
+  size_t room = size - (head - tail);
+  if (len > room)
+    len = room;
+
+  // Copy in (up to) two pieces, in case the ring wraps around.
+  size_t offset = head & mask;
+  size_t first  = size - offset;
+  if (first > len)
+    first = len;
+  memcpy( &dev.input[ offset ], buf, first );
+  memcpy( &dev.input[ 0 ], buf + first, len - first );
+
+  dev.head.store( head + len, std::memory_order_release );
+
+  if (len) {
+    m_generation++;
+
+    //  A worker that is about to sleep holds the lock from the time
+    //    it counts itself in /m_sleeping/ until it waits, so taking
+    //    the lock here means it will either see the new generation or
+    //    get this notification.
+    if (m_sleeping.load()) {
+      std::lock_guard<std::mutex> lock( m_wakeLock );
+      m_wake.notify_one();
+    }
+  }
+
+  return len;
+
+} // ingest
+
+//----------------------------------------------------------------
+
+size_t ReceiverPool::available( size_t device )
+{
+  device_t &dev = *m_devices[ device ];
+  std::lock_guard<std::mutex> lock( dev.fixLock );
+  return dev.fixes.size();
+
+} // available
+
+//----------------------------------------------------------------
+
+bool ReceiverPool::read( size_t device, gps_fix & fix )
+{
+  device_t &dev = *m_devices[ device ];
+  std::lock_guard<std::mutex> lock( dev.fixLock );
+
+  if (dev.fixes.empty())
+    return false;
+
+  fix = dev.fixes.front();
+  dev.fixes.pop_front();
+  return true;
+
+} // read
+
+//----------------------------------------------------------------
+
+uint32_t ReceiverPool::overruns( size_t device )
+{
+  device_t &dev = *m_devices[ device ];
+  std::lock_guard<std::mutex> lock( dev.fixLock );
+  return dev.overruns;
+
+} // overruns
+
+//----------------------------------------------------------------
+
+void ReceiverPool::drain()
+{
+  for (size_t d=0; d < m_devices.size(); d++) {
+    device_t &dev = *m_devices[ d ];
+    while ((dev.tail.load( std::memory_order_acquire ) !=
+            dev.head.load( std::memory_order_acquire )) ||
+           dev.busy.load( std::memory_order_acquire ))
+      std::this_thread::yield();
+  }
+
+} // drain
+
+//----------------------------------------------------------------
+//  Called by the parser for each completed fix.
+
+void ReceiverPool::onFix( const gps_fix & fix, void *context )
+{
+  device_t &dev = *(device_t *) context;
+  std::lock_guard<std::mutex> lock( dev.fixLock );
+
+  if (dev.fixes.size() >= dev.fixQueueSize) {
+    dev.fixes.pop_front();
+    dev.overruns++;
+  }
+  dev.fixes.push_back( fix );
+
+} // onFix
+
+//----------------------------------------------------------------
+//  Parse (some of) the pending characters for one device.
+//    Returns false if there was nothing to do, or if another worker
+//    is already parsing this device.
+
+bool ReceiverPool::service( size_t device )
+{
+  device_t &dev = *m_devices[ device ];
+
+  size_t tail = dev.tail.load( std::memory_order_relaxed );
+  if (tail == dev.head.load( std::memory_order_acquire ))
+    return false;
+
+  if (dev.busy.exchange( true, std::memory_order_acquire ))
+    return false;
+
+  // Re-read, another worker may have finished it.
+  tail = dev.tail.load( std::memory_order_relaxed );
+  size_t head = dev.head.load( std::memory_order_acquire );
+  size_t mask = dev.input.size() - 1;
+  size_t todo = head - tail;
+  if (todo > QUANTUM)
+    todo = QUANTUM;
+
+  while (todo) {
+    size_t offset = tail & mask;
+    size_t len    = dev.input.size() - offset; // contiguous
+    if (len > todo)
+      len = todo;
+
+    dev.gps->handle( &dev.input[ offset ], len, onFix, &dev );
+
+    tail += len;
+    todo -= len;
+  }
+
+  dev.tail.store( tail, std::memory_order_release );
+  dev.busy.store( false, std::memory_order_release );
+
+  return true;
+
+} // service
+
+//----------------------------------------------------------------
+
+void ReceiverPool::run( size_t worker )
+{
+  const size_t devices = m_devices.size();
+  const size_t workers = m_workerCount;
+  const size_t first   = (worker   * devices) / workers;
+  const size_t last    = ((worker+1) * devices) / workers;
+        size_t victim  = last;
+
+  for (;;) {
+    if (m_stop)
+      return;
+    uint64_t seen = m_generation;
+
+    bool worked = false;
+
+    for (size_t d=first; d < last; d++)
+      if (service( d ))
+        worked = true;
+
+    if (!worked) {
+      //  Nothing at home, try to steal one turn from another device.
+      for (size_t i=0; i < devices; i++) {
+        if (victim >= devices)
+          victim = 0;
+        size_t d = victim++;
+        if (((d < first) || (last <= d)) && service( d )) {
+          m_steals++;
+          worked = true;
+          break;
+        }
+      }
+    }
+
+    if (!worked) {
+      std::unique_lock<std::mutex> lock( m_wakeLock );
+      m_sleeping++;
+      while (!m_stop && (m_generation == seen))
+        m_wake.wait( lock );
+      m_sleeping--;
+    }
+  }
+
+} // run
@@ -0,0 +1,143 @@
+#ifndef RECEIVERPOOL_H
+#define RECEIVERPOOL_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NMEAGPS.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NeoGPS {
+
+//------------------------------------------------------
+//
+// Parses the data from many GPS devices on a pool of worker threads.
+// This is host-only code: it requires C++11 threads.
+//
+// Each device has its own parser, created by the /factory/ (an
+// NMEAGPS by default, or any derived class like ubloxGPS).  The
+// characters received from a device are passed to /ingest/, which
+// copies them into that device's input ring and wakes a worker.
+//
+// Each worker has a home range of devices.  When none of them have
+// data, it steals work from the other devices.  A device is only
+// parsed by one worker at a time, and at most /QUANTUM/ characters
+// are parsed per turn, so that busy devices do not starve quiet ones.
+//
+// Completed fixes are stored in a per-device queue, and they are
+// removed with /read/.  If the queue is full, the oldest fix is
+// dropped and the device's /overruns/ count is incremented.
+
+class ReceiverPool
+{
+  ReceiverPool & operator =( const ReceiverPool & );
+  ReceiverPool( const ReceiverPool & );
+
+public:
+
+  typedef NMEAGPS *(*factory_t)( size_t device, void *context );
+
+  ReceiverPool( size_t devices, size_t workers = 0, // 0 means all cores
+                factory_t factory = (factory_t) NULL, void *context = NULL,
+                size_t inputSize = 8192, size_t fixQueueSize = 16 );
+  ~ReceiverPool();
+
+  size_t devices() const { return m_devices.size(); };
+  size_t workers() const { return m_workerCount; };
+
+  //.......................................................................
+  //  Pass characters received from a device to its parser.  Only one
+  //    thread should ingest characters for each device.  Returns the
+  //    number of characters accepted; fewer than /len/ are accepted
+  //    when the device's input ring is full.
+
+  size_t ingest( size_t device, const uint8_t *buf, size_t len );
+
+  //.......................................................................
+  //  Fix-oriented access, per device.  These are safe to call from any
+  //    thread.
+
+  size_t available( size_t device );
+  bool   read     ( size_t device, gps_fix & fix );
+
+  uint32_t overruns ( size_t device );
+
+  //.......................................................................
+  //  Wait until all ingested characters have been parsed.
+
+  void drain();
+
+  //.......................................................................
+  //  The parser for a device.  Its members should only be examined
+  //    after /drain/, when no other characters are being ingested.
+
+  NMEAGPS & parser( size_t device ) { return *m_devices[ device ]->gps; };
+
+  //  Number of turns a worker parsed a device outside its home range.
+  uint64_t steals() const { return m_steals.load(); };
+
+  //  Most characters parsed from one device in one turn.
+  static const size_t QUANTUM = 4096;
+
+private:
+
+  struct device_t
+  {
+    NMEAGPS                *gps;
+
+    //  Input ring: written by /ingest/, read by the worker that
+    //    holds /busy/.  /head/ and /tail/ are free-running.
+    std::vector<uint8_t>    input;
+    std::atomic<size_t>     head;
+    std::atomic<size_t>     tail;
+    std::atomic<bool>       busy;
+
+    std::mutex              fixLock;
+    std::deque<gps_fix>     fixes;
+    size_t                  fixQueueSize;
+    uint32_t                overruns;
+  };
+
+  std::vector<device_t *>    m_devices;
+  std::vector<std::thread>   m_workers;
+  size_t                     m_workerCount;
+
+  //  Idle workers wait on /m_wake/.  /ingest/ only takes /m_wakeLock/
+  //    when /m_sleeping/ workers might be waiting.
+  std::mutex                 m_wakeLock;
+  std::condition_variable    m_wake;
+  std::atomic<uint64_t>      m_generation; // incremented by each ingest
+  std::atomic<size_t>        m_sleeping;   // workers waiting on m_wake
+  std::atomic<bool>          m_stop;
+
+  std::atomic<uint64_t>      m_steals;
+
+  static void onFix( const gps_fix & fix, void *context );
+
+  void run    ( size_t worker );
+  bool service( size_t device );
+};
+
+} // namespace NeoGPS
+
+#endif
@@ -0,0 +1,219 @@
+//======================================================================
+//  Program: LocationBatchBenchmark.cpp
+//
+//  Description:  Compares the batch Location_t calculations (one
+//     origin, many points) with calling the single-point versions in
+//     Location.cpp for each point.
+//
+//     The points are spread around the origin, from a few meters to
+//     the other side of the earth.  For each calculation, it reports
+//     the ns/point of the single-point loop, the batch call with a
+//     Location_t array, and the batch call with separate latitude and
+//     longitude arrays.  It also reports the largest errors of the
+//     single-point and batch results, compared to the same formula
+//     calculated with doubles.
+//
+//     This is a host program.  It is built by the CMakeLists.txt in
+//     the top NeoGPS directory (see extras/host/README.md).
+//
+//  Usage:  LocationBatchBenchmark [points [repeats]]
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include "Location.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using NeoGPS::Location_t;
+
+//--------------------------
+//  Repeatable pseudo-random numbers
+
+static uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+static double random01()
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return (state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//--------------------------
+//  The double-precision reference
+
+static const double D2R = M_PI / 180.0;
+
+static double latR( const Location_t & p ) { return p.lat() * 1e-7 * D2R; }
+static double dLonR( const Location_t & p1, const Location_t & p2 )
+{
+  return remainder( (p2.lon() - (double) p1.lon()) * 1e-7 * D2R, 2*M_PI );
+}
+
+static double refDistance( const Location_t & p1, const Location_t & p2 )
+{
+  double lat1 = latR( p1 ), lat2 = latR( p2 ), dLon = dLonR( p1, p2 );
+
+  double y = cos(lat2) * sin(dLon);
+  double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon);
+  double z = sin(lat1) * sin(lat2) + cos(lat1) * cos(lat2) * cos(dLon);
+  return atan2( hypot( x, y ), z );
+}
+
+static double refEquirect( const Location_t & p1, const Location_t & p2 )
+{
+  double dLat = latR( p2 ) - latR( p1 );
+  double x    = dLonR( p1, p2 ) * cos( latR( p1 ) + dLat/2 );
+  return hypot( x, dLat );
+}
+
+static double refBearing( const Location_t & p1, const Location_t & p2 )
+{
+  double lat1 = latR( p1 ), lat2 = latR( p2 ), dLon = dLonR( p1, p2 );
+
+  double y = cos(lat2) * sin(dLon);
+  double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon);
+  return atan2( y, x );
+}
+
+//--------------------------
+
+template <class F>
+static double nsPerPoint( size_t points, size_t repeats, F f )
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r=0; r < repeats; r++)
+    f();
+  auto end   = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>( end - start ).count() /
+         (points * repeats);
+}
+
+//--------------------------
+
+typedef float  (*pointFunction_t)( const Location_t &, const Location_t & );
+typedef double (*refFunction_t)  ( const Location_t &, const Location_t & );
+typedef void  (*arrayFunction_t)
+  ( const Location_t &, const Location_t *, size_t, float * );
+typedef void  (*soaFunction_t)
+  ( const Location_t &, const int32_t *, const int32_t *, size_t, float * );
+
+static void compare
+  ( const char *name, bool angle, refFunction_t refF,
+    pointFunction_t pointF, arrayFunction_t arrayF, soaFunction_t soaF,
+    const Location_t & origin, const std::vector<Location_t> & points,
+    const std::vector<int32_t> & lats, const std::vector<int32_t> & lons,
+    size_t repeats )
+{
+  size_t n = points.size();
+  std::vector<float> single( n ), array( n ), soa( n );
+
+  double singleNs = nsPerPoint( n, repeats, [&]() {
+      for (size_t i=0; i < n; i++)
+        single[i] = pointF( origin, points[i] );
+    } );
+  double arrayNs = nsPerPoint( n, repeats, [&]() {
+      arrayF( origin, points.data(), n, array.data() );
+    } );
+  double soaNs = nsPerPoint( n, repeats, [&]() {
+      soaF( origin, lats.data(), lons.data(), n, soa.data() );
+    } );
+
+  //  Largest errors, in meters (or degrees for bearings)
+  double singleErr = 0, batchErr = 0;
+  for (size_t i=0; i < n; i++) {
+    if (array[i] != soa[i]) {
+      printf( "%s: array and lat/lon results differ at %zu\n", name, i );
+      exit( 1 );
+    }
+
+    double ref = refF( origin, points[i] );
+    double e1  = (double) single[i] - ref;
+    double e2  = (double) soa   [i] - ref;
+    if (angle) {
+      e1 = remainder( e1, 2*M_PI ) / D2R;
+      e2 = remainder( e2, 2*M_PI ) / D2R;
+    } else {
+      e1 *= Location_t::EARTH_RADIUS_KM * 1000.0;
+      e2 *= Location_t::EARTH_RADIUS_KM * 1000.0;
+    }
+    if (singleErr < fabs(e1))
+      singleErr = fabs(e1);
+    if (batchErr < fabs(e2))
+      batchErr = fabs(e2);
+  }
+
+  printf( "%-24s %8.2f %8.2f %8.2f %7.1fx %10.3g %10.3g %s\n",
+          name, singleNs, arrayNs, soaNs, singleNs / soaNs,
+          singleErr, batchErr, angle ? "deg" : "m" );
+}
+
+//--------------------------
+
+int main( int argc, char *argv[] )
+{
+  size_t n       = (argc > 1) ? strtoul( argv[1], nullptr, 0 ) : 4096;
+  size_t repeats = (argc > 2) ? strtoul( argv[2], nullptr, 0 ) : 200;
+
+  Location_t origin( (int32_t) 404381311L, (int32_t) -38196229L );
+
+  std::vector<Location_t> points( n );
+  std::vector<int32_t>    lats( n ), lons( n );
+
+  for (size_t i=0; i < n; i++) {
+    //  Distances from 10^0.5 to 10^7.3 meters
+    Location_t p( origin );
+    p.OffsetBy( (float) (pow( 10.0, 0.5 + 6.8 * random01() ) /
+                         (Location_t::EARTH_RADIUS_KM * 1000.0)),
+                (float) (random01() * 2 * M_PI) );
+    if (p.lon() < -1800000000L) // OffsetBy does not wrap
+      p.lon( p.lon() + 1800000000L + 1800000000L );
+    points[i] = p;
+    lats  [i] = p.lat();
+    lons  [i] = p.lon();
+  }
+
+  printf( "Location_t batch calculations, %zu points x %zu\n\n", n, repeats );
+  printf( "%-24s %8s %8s %8s %8s %10s %10s\n",
+          "ns/point", "single", "array", "lat/lon", "speedup",
+          "single err", "batch err" );
+
+  compare( "DistanceRadians", false, &refDistance,
+           &Location_t::DistanceRadians, &Location_t::DistanceRadians,
+           &Location_t::DistanceRadians,
+           origin, points, lats, lons, repeats );
+  compare( "EquirectDistanceRadians", false, &refEquirect,
+           &Location_t::EquirectDistanceRadians,
+           &Location_t::EquirectDistanceRadians,
+           &Location_t::EquirectDistanceRadians,
+           origin, points, lats, lons, repeats );
+  compare( "BearingTo", true, &refBearing,
+           &Location_t::BearingTo, &Location_t::BearingTo,
+           &Location_t::BearingTo,
+           origin, points, lats, lons, repeats );
+
+  return 0;
+}
@@ -0,0 +1,249 @@
+//======================================================================
+//  Program: LocationBenchmark.cpp
+//
+//  Description:  Measures the speed and accuracy of the Location_t
+//     distance, bearing and offset calculations.
+//
+//     Random pairs of locations are generated at several distances,
+//     from 1m to 10000km.  Each result is compared with the same
+//     formula calculated with doubles.  Distance and offset errors are
+//     in meters, and bearing errors are in degrees.
+//
+//     This program is built twice: LocationBenchmark uses the float
+//     versions in Location.cpp, and LocationBenchmark_Fixed uses the
+//     integer versions in LocationFixed.cpp
+//     (NEOGPS_FIXED_POINT_LOCATION).
+//
+//     This is a host program.  It is built by the CMakeLists.txt in
+//     the top NeoGPS directory (see extras/host/README.md).
+//
+//  Usage:  LocationBenchmark [pairs]
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include "Location.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using NeoGPS::Location_t;
+
+#ifdef NEOGPS_FIXED_POINT_LOCATION
+  static const char *implementation = "fixed (LocationFixed.cpp)";
+#else
+  static const char *implementation = "float (Location.cpp)";
+#endif
+
+static const double R = Location_t::EARTH_RADIUS_KM * 1000.0; // meters
+static const double D2R = M_PI / 180.0;
+
+//--------------------------
+//  Repeatable pseudo-random numbers
+
+static uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+static double random01()
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return (state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//--------------------------
+//  The double-precision reference
+
+static double latR( const Location_t & p ) { return p.lat() * 1e-7 * D2R; }
+static double lonR( const Location_t & p ) { return p.lon() * 1e-7 * D2R; }
+
+static double refDistance( const Location_t & p1, const Location_t & p2 )
+{
+  double lat1 = latR( p1 ), lat2 = latR( p2 );
+  double dLon = lonR( p2 ) - lonR( p1 );
+
+  double y = cos(lat2) * sin(dLon);
+  double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon);
+  double z = sin(lat1) * sin(lat2) + cos(lat1) * cos(lat2) * cos(dLon);
+  return atan2( hypot( x, y ), z );
+}
+
+static double refBearing( const Location_t & p1, const Location_t & p2 )
+{
+  double lat1 = latR( p1 ), lat2 = latR( p2 );
+  double dLon = lonR( p2 ) - lonR( p1 );
+
+  double y = cos(lat2) * sin(dLon);
+  double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon);
+  double b = atan2( y, x );
+  return (b < 0) ? b + 2*M_PI : b;
+}
+
+static void refOffset
+  ( const Location_t & p, double dist, double bearing,
+    double & lat2, double & lon2 )
+{
+  double lat1 = latR( p );
+  lat2 = asin( sin(lat1) * cos(dist) + cos(lat1) * sin(dist) * cos(bearing) );
+  lon2 = lonR( p ) +
+         atan2( sin(bearing) * sin(dist) * cos(lat1),
+                cos(dist) - sin(lat1) * sin(lat2) );
+}
+
+//--------------------------
+
+struct pair_t
+{
+  Location_t p1, p2;
+  float      dist, bearing; // for OffsetBy
+};
+
+static void makePairs( std::vector<pair_t> & pairs, double meters )
+{
+  for (size_t i=0; i < pairs.size(); i++) {
+    pair_t & p = pairs[i];
+
+    double lat = (random01() * 160.0) - 80.0;
+    double lon = (random01() * 360.0) - 180.0;
+    p.p1 = Location_t( (int32_t) (lat * 1e7), (int32_t) (lon * 1e7) );
+
+    p.dist    = (float) (meters * (0.5 + random01()) / R);
+    p.bearing = (float) (random01() * 2 * M_PI);
+
+    double lat2, lon2;
+    refOffset( p.p1, p.dist, p.bearing, lat2, lon2 );
+    lon2 = remainder( lon2, 2*M_PI );
+    p.p2 = Location_t( (int32_t) lround( lat2 / D2R * 1e7 ),
+                       (int32_t) lround( lon2 / D2R * 1e7 ) );
+  }
+}
+
+//--------------------------
+
+struct error_t
+{
+  double max, sumSq;
+  size_t n;
+
+  error_t() : max(0), sumSq(0), n(0) {}
+
+  void add( double e )
+    {
+      e = fabs(e);
+      if (max < e)
+        max = e;
+      sumSq += e*e;
+      n++;
+    }
+  double rms() const { return n ? sqrt( sumSq / n ) : 0; }
+};
+
+template <class F>
+static double nsPerCall( size_t n, F f )
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end   = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>( end - start ).count() / n;
+}
+
+//--------------------------
+
+int main( int argc, char *argv[] )
+{
+  size_t n = (argc > 1) ? strtoul( argv[1], nullptr, 0 ) : 100000;
+
+  printf( "Location_t calculations, %s, %zu pairs\n\n", implementation, n );
+  printf( "%10s | %-24s | %-24s | %-24s\n", "",
+          "DistanceRadians", "BearingTo", "OffsetBy" );
+  printf( "%10s | %7s %8s %7s | %7s %8s %7s | %7s %8s %7s\n",
+          "distance",
+          "ns/call", "max m", "rms m",
+          "ns/call", "max deg", "rms deg",
+          "ns/call", "max m", "rms m" );
+
+  static const double scales[] = { 1, 100, 10e3, 1000e3, 10000e3 };
+  std::vector<pair_t> pairs( n );
+  volatile float sink;
+
+  for (double meters : scales) {
+    makePairs( pairs, meters );
+
+    float  sum = 0;
+    double distNs = nsPerCall( n, [&]() {
+        for (const pair_t & p : pairs)
+          sum += Location_t::DistanceRadians( p.p1, p.p2 );
+      } );
+    double bearingNs = nsPerCall( n, [&]() {
+        for (const pair_t & p : pairs)
+          sum += Location_t::BearingTo( p.p1, p.p2 );
+      } );
+    std::vector<Location_t> offsets( n );
+    double offsetNs = nsPerCall( n, [&]() {
+        for (size_t i=0; i < n; i++) {
+          offsets[i] = pairs[i].p1;
+          offsets[i].OffsetBy( pairs[i].dist, pairs[i].bearing );
+        }
+      } );
+    sink = sum;
+
+    error_t distErr, bearingErr, offsetErr;
+    for (size_t i=0; i < n; i++) {
+      const pair_t & p = pairs[i];
+
+      double ref = refDistance( p.p1, p.p2 );
+      distErr.add( (Location_t::DistanceRadians( p.p1, p.p2 ) - ref) * R );
+
+      //  The bearing is not well defined for very short distances,
+      //    where it depends on the rounding of the coordinates.
+      if (ref * R > 0.5) {
+        double e = Location_t::BearingTo( p.p1, p.p2 ) - refBearing( p.p1, p.p2 );
+        bearingErr.add( remainder( e, 2*M_PI ) / D2R );
+      }
+
+      double lat2, lon2;
+      refOffset( p.p1, p.dist, p.bearing, lat2, lon2 );
+      double dLat = latR( offsets[i] ) - lat2;
+      double dLon = remainder( lonR( offsets[i] ) - lon2, 2*M_PI ) * cos( lat2 );
+      offsetErr.add( hypot( dLat, dLon ) * R );
+    }
+
+    char label[16];
+    if (meters < 1000)
+      snprintf( label, sizeof(label), "%gm", meters );
+    else
+      snprintf( label, sizeof(label), "%gkm", meters / 1000 );
+
+    printf( "%10s | %7.1f %8.3g %7.2g | %7.1f %8.3g %7.2g | %7.1f %8.3g %7.2g\n",
+            label,
+            distNs   , distErr.max   , distErr.rms(),
+            bearingNs, bearingErr.max, bearingErr.rms(),
+            offsetNs , offsetErr.max , offsetErr.rms() );
+  }
+  (void) sink;
+
+  printf( "\nOffsetBy includes the rounding to 1e-7 degrees (up to 8mm).\n" );
+
+  return 0;
+}
@@ -0,0 +1,211 @@
+//======================================================================
+//  Program: LogReplayBenchmark.cpp
+//
+//  Description:  Replays a log file with LogReplay, from 1 thread up
+//     to all cores, and checks that every replay produces the same
+//     fixes as the single-threaded replay.
+//
+//     If no log file is given, a synthetic log is generated.  It has
+//     RMC, GSA and GSV sentences in each interval, GGA sentences in
+//     half of them, plus some binary UBX data and corrupted sentences.
+//
+//     This is a host program.  It is built by the CMakeLists.txt in
+//     the top NeoGPS directory (see extras/host/README.md).
+//
+//  Usage:  LogReplayBenchmark [logfile [max-threads]]
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include "LogReplay.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+using NeoGPS::LogReplay;
+
+//--------------------------
+
+static void append( std::string & out, const char *body )
+{
+  uint8_t crc = 0;
+  for (const char *c = body; *c; c++)
+    crc ^= (uint8_t) *c;
+
+  char tail[8];
+  snprintf( tail, sizeof(tail), "*%02X\r\n", crc );
+
+  out += '$';
+  out += body;
+  out += tail;
+}
+
+//--------------------------
+
+static void generate( std::string & out, unsigned seconds )
+{
+  char body[120];
+
+  for (unsigned s=0; s < seconds; s++) {
+    unsigned hh = (s / 3600) % 24, mm = (s / 60) % 60, ss = s % 60;
+
+    //  The GGA is missing from half of the intervals.  With implicit
+    //    merging, the altitude is carried from an earlier interval,
+    //    maybe in an earlier chunk.  Those intervals are not corrupted,
+    //    because a rejected sentence would clear the altitude.
+    bool gga = ((s % 1000) < 500);
+    if (gga) {
+      snprintf( body, sizeof(body),
+                "GPGGA,%02u%02u%02u.00,4717.%05u,N,00833.91590,E,1,8,1.01,%u.6,M,48.0,M,,0",
+                hh, mm, ss, s % 100000, 400 + s % 200 );
+      append( out, body );
+    }
+
+    append( out, "GPGSA,A,3,23,29,07,08,09,18,26,28,,,,,1.94,1.18,1.54" );
+    append( out, "GPGSV,2,1,08,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36" );
+    append( out, "GPGSV,2,2,08,10,07,189,,05,05,220,,09,34,274,42,18,25,309,44" );
+
+    if (gga && ((s % 97) == 13)) {
+      // Some binary UBX data, with a '$' in it
+      static const char ubx[] = "\xB5\x62\x01\x07\x08\x00$GP\x00\x01\x02\x03\x04\x0A\x0B";
+      out.append( ubx, sizeof(ubx)-1 );
+    }
+
+    snprintf( body, sizeof(body),
+              "GPRMC,%02u%02u%02u.00,A,4717.%05u,N,00833.91590,E,0.004,77.52,091202,,,A",
+              hh, mm, ss, s % 100000 );
+    append( out, body );
+    if (gga && ((s % 53) == 7))
+      out[ out.size() - 20 ] ^= 1; // bad checksum
+  }
+}
+
+//--------------------------
+//  Summarize the fixes so that replays can be compared.
+
+struct summary_t
+{
+  size_t   count;
+  uint64_t hash;
+
+  static void onFix( const gps_fix & fix, void *context )
+    {
+      summary_t *s = (summary_t *) context;
+      uint64_t   h = s->hash;
+      s->count++;
+
+      //  Invalid members may have stale values, so skip them.
+      #ifdef GPS_FIX_LOCATION
+        h = h * 1000003 + fix.valid.location;
+        if (fix.valid.location) {
+          h = h * 1000003 + (uint32_t) fix.location.lat();
+          h = h * 1000003 + (uint32_t) fix.location.lon();
+        }
+      #endif
+      #ifdef GPS_FIX_TIME
+        h = h * 1000003 + fix.valid.time;
+        if (fix.valid.time)
+          h = h * 1000003 + fix.dateTime_cs + 100 * (uint32_t)
+              (fix.dateTime.hours * 3600L + fix.dateTime.minutes * 60 + fix.dateTime.seconds);
+      #endif
+      #ifdef GPS_FIX_DATE
+        h = h * 1000003 + fix.valid.date;
+        if (fix.valid.date)
+          h = h * 1000003 + fix.dateTime.date + 32 * fix.dateTime.month +
+                            512 * (uint32_t) fix.dateTime.year;
+      #endif
+      #ifdef GPS_FIX_ALTITUDE
+        h = h * 1000003 + fix.valid.altitude;
+        if (fix.valid.altitude)
+          h = h * 1000003 + (uint32_t) fix.altitude_cm();
+      #endif
+
+      s->hash = h;
+    }
+};
+
+//--------------------------
+
+int main( int argc, char *argv[] )
+{
+  LogReplay   replay;
+  std::string synthetic;
+
+  const uint8_t *buf;
+  size_t         len;
+
+  if ((argc > 1) && (argv[1][0] != '-')) {
+    if (!replay.open( argv[1] )) {
+      perror( argv[1] );
+      return 1;
+    }
+    buf = replay.data();
+    len = replay.size();
+  } else {
+    generate( synthetic, 400000 );
+    buf = (const uint8_t *) synthetic.data();
+    len = synthetic.size();
+  }
+
+  size_t cores = (argc > 2) ? strtoul( argv[2], NULL, 0 )
+                            : std::thread::hardware_concurrency();
+  if (cores == 0)
+    cores = 1;
+
+  printf( "LogReplayBenchmark: %zu bytes, %zu cores\n", len, cores );
+  printf( "threads      fixes    seconds   MB/s  speedup  same\n" );
+
+  summary_t first = { 0, 0 };
+  double    base  = 0.0;
+
+  for (size_t t=1; t <= cores; t = (t < cores) && (2*t > cores) ? cores : 2*t) {
+    summary_t summary = { 0, 0 };
+
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+    replay.replay( buf, len, summary_t::onFix, &summary, t );
+
+    double elapsed =
+      std::chrono::duration<double>
+        ( std::chrono::steady_clock::now() - start ).count();
+
+    if (t == 1) {
+      first = summary;
+      base  = elapsed;
+    }
+    bool same = (summary.count == first.count) && (summary.hash == first.hash);
+
+    printf( "%7zu %10zu %10.3f %6.1f %8.2f  %s\n",
+            t, summary.count, elapsed, len / elapsed / 1.0e6,
+            base / elapsed, same ? "yes" : "NO" );
+
+    #ifdef NMEAGPS_STATS
+      printf( "        ok %u, errors %u, chars %u\n",
+              replay.statistics().ok, replay.statistics().errors,
+              replay.statistics().chars );
+    #endif
+  }
+
+  return 0;
+}
@@ -0,0 +1,929 @@
+//======================================================================
+//  Program: ParserBenchmark.cpp
+//
+//  Description:  Measures the parser's speed for each sentence type,
+//     and for mixed, corrupted and UBX streams.  This is the host
+//     version of NMEAbenchmark.ino.
+//
+//     Each workload is a synthetic stream of 1000 update intervals.
+//     It is parsed one character at a time ("char", like a sketch
+//     that calls gps.available( port )), and as one block ("bulk",
+//     with the NMEAGPS::handle( buf, len ) method).  Each is repeated
+//     for at least the minimum time.
+//
+//     A fix is only completed by the LAST_SENTENCE_IN_INTERVAL (see
+//     NMEAGPS_cfg.h), so most single-sentence workloads have no fixes.
+//     The "mixed" workload does not include the multi-GNSS sentences
+//     (DTM, GBS, GNS, GRS and HDT), so its results can be compared
+//     with earlier runs.
+//
+//     The CMakeLists.txt in the top NeoGPS directory builds one
+//     version of this program for each configuration in
+//     extras/configs (e.g., ParserBenchmark_Full), and one for the
+//     configuration in src (ParserBenchmark).  The "ParserBenchmarks"
+//     target runs all of them and writes ParserBenchmarks.json.
+//
+//     If the configuration enables NMEAGPS_DERIVED_TYPES and
+//     NMEAGPS_PARSE_PROPRIETARY (e.g., PUBX), a ubloxGPS parser is
+//     used.  Otherwise, the PUBX and UBX data is skipped by NMEAGPS.
+//
+//     The report also shows whether the bulk mode converts the time,
+//     date and lat/lon fields 8 characters at a time
+//     (NMEAGPS_SWAR_FIELDS in NMEAGPS_cfg.h).
+//
+//     If NMEAGPS_LAZY_FIX is enabled, each workload is also parsed
+//     into a lazy_fix ("lazy"), and the handler only uses the location
+//     and the time, like most applications.
+//
+//     If NMEAGPS_RUNTIME_PROFILE is enabled (ParserBenchmark_Profile),
+//     the mixed stream is also parsed with a profile that only selects
+//     GGA and RMC, and the location and time ("GGA+RMC").  The other
+//     workloads use the default profile, so they can be compared with
+//     ParserBenchmark to see the cost of the run-time checks.
+//
+//  Usage:  ParserBenchmark [--min-time=seconds] [--filter=text]
+//                          [--json=file] [--check]
+//
+//     --filter runs only the workloads whose names contain the text.
+//     --json appends the results to the file, as one JSON object per
+//     line.
+//     --check does not measure anything.  Instead, each workload is
+//     parsed one character at a time, as one block, and as blocks
+//     split at random points, and every member of every fix must be
+//     the same in each mode.  The exit status is 1 if they are not.
+//     CMakeLists.txt adds this as a test for each configuration
+//     ("ctest" runs them).
+//
+//     With NMEAGPS_IMPLICIT_MERGING, the corrupted workload is checked
+//     without its bad checksums ("truncated").  The char mode parses
+//     the fields of a sentence before its checksum is received, and a
+//     bad checksum then invalidates the merged fix.  The bulk mode
+//     skips that sentence, unless it was split across two blocks (see
+//     "Data Model.md").
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include "NMEAGPS.h"
+
+#ifdef NMEAGPS_LAZY_FIX
+  #include "LazyFix.h"
+#endif
+
+#if defined(NMEAGPS_DERIVED_TYPES) & defined(NMEAGPS_PARSE_PROPRIETARY)
+  #include "ublox/ubxGPS.h"
+  #define UBLOX_PARSER
+#endif
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifndef NEOGPS_CONFIG
+  #define NEOGPS_CONFIG "src"
+#endif
+
+#ifdef NMEAGPS_SWAR_FIELDS
+  static const bool swarFields = true;
+#else
+  static const bool swarFields = false;
+#endif
+
+#ifdef UBLOX_PARSER
+  typedef ubloxGPS parser_t;
+  static parser_t *newParser() { return new ubloxGPS( (Stream *) NULL ); }
+#else
+  typedef NMEAGPS parser_t;
+  static parser_t *newParser() { return new NMEAGPS; }
+#endif
+
+static const unsigned INTERVALS = 1000;
+
+//--------------------------
+
+struct workload_t
+{
+  const char *name;
+  std::string data;
+  size_t      sentences;
+  bool        ggaRmc;    // parsed with the GGA+RMC profile
+};
+
+//--------------------------
+
+static void append( workload_t & w, const char *body )
+{
+  uint8_t crc = 0;
+  for (const char *c = body; *c; c++)
+    crc ^= (uint8_t) *c;
+
+  char tail[8];
+  snprintf( tail, sizeof(tail), "*%02X\r\n", crc );
+
+  w.data += '$';
+  w.data += body;
+  w.data += tail;
+  w.sentences++;
+}
+
+//--------------------------
+//  One sentence of each type, for interval /s/.
+
+enum sentence_t
+  { GGA, GLL, GSA, GSV, GST, RMC, VTG, ZDA, DTM, GBS, GNS, GRS, HDT,
+    PUBX00, PUBX04, SENTENCE_TYPES };
+
+static const char * const sentenceNames[ SENTENCE_TYPES ] =
+  { "GGA", "GLL", "GSA", "GSV", "GST", "RMC", "VTG", "ZDA",
+    "DTM", "GBS", "GNS", "GRS", "HDT", "PUBX00", "PUBX04" };
+
+static void appendSentence( workload_t & w, sentence_t type, unsigned s )
+{
+  unsigned hh = (s / 3600) % 24, mm = (s / 60) % 60, ss = s % 60;
+  char     body[120];
+
+  switch (type) {
+    case GGA:
+      snprintf( body, sizeof(body),
+                "GPGGA,%02u%02u%02u.00,4717.%05u,N,00833.91590,E,1,08,1.01,%u.6,M,48.0,M,,",
+                hh, mm, ss, s % 100000, 400 + s % 200 );
+      append( w, body );
+      break;
+
+    case GLL:
+      snprintf( body, sizeof(body),
+                "GPGLL,4717.%05u,N,00833.91565,E,%02u%02u%02u.00,A,A",
+                s % 100000, hh, mm, ss );
+      append( w, body );
+      break;
+
+    case GSA:
+      append( w, "GPGSA,A,3,23,29,07,08,09,18,26,28,,,,,1.94,1.18,1.54" );
+      break;
+
+    case GSV:
+      append( w, "GPGSV,3,1,10,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36" );
+      append( w, "GPGSV,3,2,10,10,07,189,,05,05,220,,09,34,274,42,18,25,309,44" );
+      append( w, "GPGSV,3,3,10,26,82,187,47,28,43,056,46" );
+      break;
+
+    case GST:
+      snprintf( body, sizeof(body),
+                "GPGST,%02u%02u%02u.00,1.5,1.1,0.8,45.0,0.9,1.2,2.%u",
+                hh, mm, ss, s % 10 );
+      append( w, body );
+      break;
+
+    case RMC:
+      snprintf( body, sizeof(body),
+                "GPRMC,%02u%02u%02u.00,A,4717.%05u,N,00833.91522,E,0.004,77.52,091202,,,A",
+                hh, mm, ss, s % 100000 );
+      append( w, body );
+      break;
+
+    case VTG:
+      append( w, "GPVTG,77.52,T,,M,0.004,N,0.008,K,A" );
+      break;
+
+    case ZDA:
+      snprintf( body, sizeof(body),
+                "GPZDA,%02u%02u%02u.00,09,12,2002,00,00", hh, mm, ss );
+      append( w, body );
+      break;
+
+    case DTM:
+      append( w, "GPDTM,W84,,0.0,N,0.0,E,0.0,W84" );
+      break;
+
+    case GBS:
+      snprintf( body, sizeof(body),
+                "GNGBS,%02u%02u%02u.00,1.5,0.8,2.%u,,,,,,",
+                hh, mm, ss, s % 10 );
+      append( w, body );
+      break;
+
+    case GNS:
+      snprintf( body, sizeof(body),
+                "GNGNS,%02u%02u%02u.00,4717.%05u,N,00833.91590,E,AAN,12,0.78,%u.6,48.0,,,V",
+                hh, mm, ss, s % 100000, 400 + s % 200 );
+      append( w, body );
+      break;
+
+    case GRS:
+      snprintf( body, sizeof(body),
+                "GNGRS,%02u%02u%02u.00,1,-0.4,0.2,1.1,-0.8,0.3,0.5,,,,,,,1,1",
+                hh, mm, ss );
+      append( w, body );
+      break;
+
+    case HDT:
+      snprintf( body, sizeof(body), "GPHDT,%u.%02u,T", s % 360, s % 100 );
+      append( w, body );
+      break;
+
+    case PUBX00:
+      snprintf( body, sizeof(body),
+                "PUBX,00,%02u%02u%02u.00,4717.%06u,N,00833.915187,E,546.589,G3,2.1,2.0,"
+                "0.007,77.52,0.007,,0.92,1.19,0.77,9,0,0",
+                hh, mm, ss, s % 1000000 );
+      append( w, body );
+      break;
+
+    case PUBX04:
+      snprintf( body, sizeof(body),
+                "PUBX,04,%02u%02u%02u.00,091202,%u.00,1196,15D,1930035,-2660.664,43,",
+                hh, mm, ss, 113851 + s );
+      append( w, body );
+      break;
+
+    default:
+      break;
+  }
+}
+
+//--------------------------
+//  All the sentences in each interval.
+
+static const sentence_t mixedOrder[] =
+  { GGA, GLL, GSA, GSV, GST, RMC, VTG, ZDA, PUBX00 };
+
+static void generateMixed( workload_t & w )
+{
+  for (unsigned s=0; s < INTERVALS; s++)
+    for (size_t i=0; i < sizeof(mixedOrder)/sizeof(mixedOrder[0]); i++)
+      appendSentence( w, mixedOrder[i], s );
+}
+
+//--------------------------
+//  The mixed stream, with bad checksums, truncated sentences and noise.
+
+static void generateCorrupted( workload_t & w, bool badChecksums = true )
+{
+  size_t count = 0;
+
+  for (unsigned s=0; s < INTERVALS; s++) {
+    for (size_t i=0; i < sizeof(mixedOrder)/sizeof(mixedOrder[0]); i++) {
+      size_t start = w.data.size();
+      appendSentence( w, mixedOrder[i], s );
+      size_t len   = w.data.size() - start;
+
+      count++;
+      if ((count % 5) == 0) {
+        if (badChecksums)
+          w.data[ start + len/2 ] ^= 0x01; // bad checksum
+      }
+      else if ((count % 11) == 0)
+        w.data.resize( start + len/2 );  // truncated, no CR/LF
+    }
+
+    if ((s % 3) == 0) {
+      // Line noise (no '$')
+      for (unsigned n=0; n < 16; n++)
+        w.data += (char) ((s * 31 + n * 7) % 0x24);
+    }
+  }
+}
+
+//--------------------------
+//  UBX binary messages, with the sync bytes and checksum.
+
+static void appendUBX
+  ( workload_t & w, uint8_t msgClass, uint8_t msgId,
+    const uint8_t *payload, uint16_t len )
+{
+  uint8_t header[4] = { msgClass, msgId, (uint8_t) len, (uint8_t) (len >> 8) };
+  uint8_t ck_a = 0, ck_b = 0;
+
+  w.data += (char) 0xB5;
+  w.data += (char) 0x62;
+  for (size_t i=0; i < sizeof(header); i++) {
+    w.data += (char) header[i];
+    ck_a += header[i];
+    ck_b += ck_a;
+  }
+  for (size_t i=0; i < len; i++) {
+    w.data += (char) payload[i];
+    ck_a += payload[i];
+    ck_b += ck_a;
+  }
+  w.data += (char) ck_a;
+  w.data += (char) ck_b;
+  w.sentences++;
+}
+
+static void put32( uint8_t *p, uint32_t v )
+{
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static void generateUBX( workload_t & w )
+{
+  const uint8_t NAV = 0x01;
+
+  for (unsigned s=0; s < INTERVALS; s++) {
+    uint32_t tow = 86400000UL + s * 1000UL;
+    uint8_t  payload[40];
+
+    // NAV-STATUS: 3D fix, valid fix
+    memset( payload, 0, sizeof(payload) );
+    put32( &payload[0], tow );
+    payload[4] = 3;
+    payload[5] = 0x0D;
+    appendUBX( w, NAV, 0x03, payload, 16 );
+
+    // NAV-TIMEGPS
+    memset( payload, 0, sizeof(payload) );
+    put32( &payload[0], tow );
+    payload[8]  = 0x2B; payload[9] = 0x07; // week 1835
+    payload[10] = 18;
+    payload[11] = 0x07;
+    appendUBX( w, NAV, 0x20, payload, 16 );
+
+    // NAV-TIMEUTC
+    memset( payload, 0, sizeof(payload) );
+    put32( &payload[0], tow );
+    payload[12] = 0xE1; payload[13] = 0x07; // 2017
+    payload[14] = 12;
+    payload[15] = 9;
+    payload[16] = (s / 3600) % 24;
+    payload[17] = (s / 60) % 60;
+    payload[18] = s % 60;
+    payload[19] = 0x07;
+    appendUBX( w, NAV, 0x21, payload, 20 );
+
+    // NAV-POSLLH
+    memset( payload, 0, sizeof(payload) );
+    put32( &payload[0], tow );
+    put32( &payload[4], 85652652 + s );
+    put32( &payload[8], 472852332 + s );
+    put32( &payload[12], 546589 );
+    put32( &payload[16], 498589 );
+    put32( &payload[20], 2100 );
+    put32( &payload[24], 3000 );
+    appendUBX( w, NAV, 0x02, payload, 28 );
+
+    // NAV-VELNED, the last message in the interval
+    memset( payload, 0, sizeof(payload) );
+    put32( &payload[0], tow );
+    put32( &payload[16], 7 );
+    put32( &payload[20], 7 );
+    put32( &payload[24], 7752000 );
+    appendUBX( w, NAV, 0x12, payload, 36 );
+  }
+}
+
+//--------------------------
+
+static void generateAll( std::vector<workload_t> & workloads )
+{
+  for (int t=0; t < SENTENCE_TYPES; t++) {
+    workload_t w = { sentenceNames[t], std::string(), 0, false };
+    for (unsigned s=0; s < INTERVALS; s++)
+      appendSentence( w, (sentence_t) t, s );
+    workloads.push_back( w );
+  }
+
+  workload_t mixed = { "mixed", std::string(), 0, false };
+  generateMixed( mixed );
+  workloads.push_back( mixed );
+
+  #ifdef NMEAGPS_RUNTIME_PROFILE
+    workload_t ggaRmc = { "GGA+RMC", std::string(), 0, true };
+    generateMixed( ggaRmc );
+    workloads.push_back( ggaRmc );
+  #endif
+
+  workload_t corrupted = { "corrupted", std::string(), 0, false };
+  generateCorrupted( corrupted );
+  workloads.push_back( corrupted );
+
+  workload_t ubx = { "UBX", std::string(), 0, false };
+  generateUBX( ubx );
+  workloads.push_back( ubx );
+}
+
+//--------------------------
+
+struct result_t
+{
+  const workload_t *workload;
+  const char       *mode;
+  size_t            fixes;      // per pass
+  size_t            iterations;
+  double            seconds;
+};
+
+static void countFix( const gps_fix &, void *context )
+{
+  (*(size_t *) context)++;
+}
+
+//  Parse the whole workload once.  Returns the number of fixes.
+
+static size_t parseChars( parser_t & gps, const workload_t & w )
+{
+  const uint8_t *ptr = (const uint8_t *) w.data.data();
+  const uint8_t *end = ptr + w.data.size();
+  size_t         fixes = 0;
+
+  while (ptr < end) {
+    gps.handle( *ptr++ );
+    while (gps.available()) {
+      gps.read();
+      fixes++;
+    }
+  }
+
+  return fixes;
+}
+
+static size_t parseBulk( parser_t & gps, const workload_t & w )
+{
+  size_t fixes = 0;
+  gps.handle( (const uint8_t *) w.data.data(), w.data.size(), countFix, &fixes );
+  return fixes;
+}
+
+#ifdef NMEAGPS_LAZY_FIX
+
+  static volatile int32_t sink;
+
+  static void useLazyFix( lazy_fix & fix, void *context )
+  {
+    #ifdef GPS_FIX_LOCATION
+      sink = fix.latitudeL() + fix.longitudeL();
+    #endif
+    #if defined(GPS_FIX_DATE) | defined(GPS_FIX_TIME)
+      sink = fix.dateTime().seconds;
+    #endif
+    (*(size_t *) context)++;
+  }
+
+  static size_t parseLazy( parser_t & gps, const workload_t & w )
+  {
+    static lazy_fix lazy;
+    size_t          fixes = 0;
+    gps.handle( (const uint8_t *) w.data.data(), w.data.size(),
+                lazy, useLazyFix, &fixes );
+    return fixes;
+  }
+
+#endif
+
+//--------------------------
+
+#ifdef NMEAGPS_RUNTIME_PROFILE
+
+  //  Just the location and time from GGA and RMC.
+
+  static NMEAGPS::profile_t ggaRmcProfile()
+  {
+    NMEAGPS::profile_t profile;
+    profile.init();
+
+    profile.sentences = 0;
+    #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
+      profile.sentences |= NMEAGPS_SENTENCE( NMEAGPS::NMEA_GGA );
+    #endif
+    #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
+      profile.sentences |= NMEAGPS_SENTENCE( NMEAGPS::NMEA_RMC );
+    #endif
+
+    profile.members.init();
+    profile.members.status = true;
+    #if defined(GPS_FIX_LOCATION) | defined(GPS_FIX_LOCATION_DMS)
+      profile.members.location = true;
+    #endif
+    #ifdef GPS_FIX_TIME
+      profile.members.time = true;
+    #endif
+
+    return profile;
+  }
+
+#endif
+
+//--------------------------
+
+enum parse_mode_t { CHAR_MODE, BULK_MODE, LAZY_MODE };
+
+static const char * const modeNames[] = { "char", "bulk", "lazy" };
+
+#ifdef NMEAGPS_LAZY_FIX
+  static const int MODES = 3;
+#else
+  static const int MODES = 2;
+#endif
+
+static size_t parse( parser_t & gps, const workload_t & w, int mode )
+{
+  switch (mode) {
+    case BULK_MODE: return parseBulk( gps, w );
+    #ifdef NMEAGPS_LAZY_FIX
+      case LAZY_MODE: return parseLazy( gps, w );
+    #endif
+    default       : return parseChars( gps, w );
+  }
+}
+
+static result_t run
+  ( const workload_t & w, int mode, double minTime )
+{
+  result_t  result = { &w, modeNames[ mode ], 0, 0, 0.0 };
+  parser_t *gps    = newParser();
+
+  #ifdef NMEAGPS_RUNTIME_PROFILE
+    if (w.ggaRmc)
+      gps->profile( ggaRmcProfile() );
+  #endif
+
+  // Warm up, and count the fixes
+  result.fixes = parse( *gps, w, mode );
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+  do {
+    parse( *gps, w, mode );
+    result.iterations++;
+
+    result.seconds =
+      std::chrono::duration<double>
+        ( std::chrono::steady_clock::now() - start ).count();
+  } while (result.seconds < minTime);
+
+  delete gps;
+
+  return result;
+}
+
+//--------------------------
+
+static double nsPerByte( const result_t & r )
+{
+  return r.seconds * 1.0e9 / (r.workload->data.size() * r.iterations);
+}
+
+static double nsPerSentence( const result_t & r )
+{
+  return r.seconds * 1.0e9 / (r.workload->sentences * r.iterations);
+}
+
+static double fixesPerSecond( const result_t & r )
+{
+  return r.fixes * r.iterations / r.seconds;
+}
+
+static void writeJSON( FILE *f, const std::vector<result_t> & results )
+{
+  fprintf( f, "{\"config\":\"%s\",\"parser\":\"%s\","
+              "\"swar_fields\":%s,"
+              "\"sizeof_parser\":%zu,\"sizeof_NMEAGPS\":%zu,\"sizeof_gps_fix\":%zu,"
+              "\"results\":[",
+           NEOGPS_CONFIG,
+           #ifdef UBLOX_PARSER
+             "ubloxGPS",
+           #else
+             "NMEAGPS",
+           #endif
+           swarFields ? "true" : "false",
+           sizeof(parser_t), sizeof(NMEAGPS), sizeof(gps_fix) );
+
+  for (size_t i=0; i < results.size(); i++) {
+    const result_t & r = results[i];
+    fprintf( f, "%s{\"workload\":\"%s\",\"mode\":\"%s\",\"bytes\":%zu,"
+                "\"sentences\":%zu,\"fixes\":%zu,\"iterations\":%zu,"
+                "\"ns_per_byte\":%.3f,\"ns_per_sentence\":%.1f,\"fixes_per_s\":%.0f}",
+             (i > 0) ? "," : "",
+             r.workload->name, r.mode, r.workload->data.size(),
+             r.workload->sentences, r.fixes, r.iterations,
+             nsPerByte( r ), nsPerSentence( r ), fixesPerSecond( r ) );
+  }
+
+  fprintf( f, "]}\n" );
+}
+
+//--------------------------
+//  --check: the fixes from each mode must be identical.
+
+typedef std::vector<gps_fix> fixes_t;
+
+static void saveFix( const gps_fix & fix, void *context )
+{
+  ((fixes_t *) context)->push_back( fix );
+}
+
+static parser_t *newCheckParser( const workload_t & w )
+{
+  parser_t *gps = newParser();
+
+  #ifdef NMEAGPS_RUNTIME_PROFILE
+    if (w.ggaRmc)
+      gps->profile( ggaRmcProfile() );
+  #else
+    (void) w;
+  #endif
+
+  return gps;
+}
+
+static void checkChars( const workload_t & w, fixes_t & fixes )
+{
+  parser_t *gps = newCheckParser( w );
+
+  for (size_t i=0; i < w.data.size(); i++) {
+    gps->handle( (uint8_t) w.data[i] );
+    while (gps->available())
+      fixes.push_back( gps->read() );
+  }
+
+  delete gps;
+}
+
+//  Pass the workload to the bulk /handle/ in blocks of 1 to 200
+//    characters, or in one block if /seed/ is 0.
+
+static void checkBlocks( const workload_t & w, fixes_t & fixes, uint32_t seed )
+{
+  parser_t      *gps  = newCheckParser( w );
+  const uint8_t *data = (const uint8_t *) w.data.data();
+  size_t         pos  = 0;
+
+  while (pos < w.data.size()) {
+    size_t len = w.data.size() - pos;
+    if (seed) {
+      seed = seed * 1103515245UL + 12345UL;
+      size_t block = 1 + (seed >> 16) % 200;
+      if (len > block)
+        len = block;
+    }
+    gps->handle( &data[ pos ], len, saveFix, &fixes );
+    pos += len;
+  }
+
+  delete gps;
+}
+
+//  Returns the name of the first member that is different, or NULL.
+
+static const char *differentMember( const gps_fix & a, const gps_fix & b )
+{
+  #define SAME(m) if (!(a.m == b.m)) return #m
+
+  if (memcmp( &a.valid, &b.valid, sizeof(a.valid) ) != 0)
+    return "valid";
+  SAME( status );
+
+  #ifdef GPS_FIX_LOCATION
+    SAME( location.lat() );
+    SAME( location.lon() );
+  #endif
+  #ifdef GPS_FIX_LOCATION_DMS
+    SAME( latitudeDMS.degrees );
+    SAME( latitudeDMS.minutes );
+    SAME( latitudeDMS.hemisphere );
+    SAME( latitudeDMS.seconds_whole );
+    SAME( latitudeDMS.seconds_frac );
+    SAME( longitudeDMS.degrees );
+    SAME( longitudeDMS.minutes );
+    SAME( longitudeDMS.hemisphere );
+    SAME( longitudeDMS.seconds_whole );
+    SAME( longitudeDMS.seconds_frac );
+  #endif
+  #ifdef GPS_FIX_ALTITUDE
+    SAME( alt.whole );
+    SAME( alt.frac );
+  #endif
+  #ifdef GPS_FIX_VELNED
+    SAME( velocity_north );
+    SAME( velocity_east );
+    SAME( velocity_down );
+  #endif
+  #ifdef GPS_FIX_SPEED
+    SAME( spd.whole );
+    SAME( spd.frac );
+  #endif
+  #ifdef GPS_FIX_HEADING
+    SAME( hdg.whole );
+    SAME( hdg.frac );
+  #endif
+  #ifdef GPS_FIX_TRUE_HEADING
+    SAME( trueHdg.whole );
+    SAME( trueHdg.frac );
+  #endif
+  #ifdef GPS_FIX_HDOP
+    SAME( hdop );
+  #endif
+  #ifdef GPS_FIX_VDOP
+    SAME( vdop );
+  #endif
+  #ifdef GPS_FIX_PDOP
+    SAME( pdop );
+  #endif
+  #ifdef GPS_FIX_LAT_ERR
+    SAME( lat_err_cm );
+  #endif
+  #ifdef GPS_FIX_LON_ERR
+    SAME( lon_err_cm );
+  #endif
+  #ifdef GPS_FIX_ALT_ERR
+    SAME( alt_err_cm );
+  #endif
+  #ifdef GPS_FIX_SPD_ERR
+    SAME( spd_err_mmps );
+  #endif
+  #ifdef GPS_FIX_HDG_ERR
+    SAME( hdg_errE5 );
+  #endif
+  #ifdef GPS_FIX_TIME_ERR
+    SAME( time_err_ns );
+  #endif
+  #ifdef GPS_FIX_GEOID_HEIGHT
+    SAME( geoidHt.whole );
+    SAME( geoidHt.frac );
+  #endif
+  #ifdef GPS_FIX_DATUM
+    if (memcmp( a.datum, b.datum, sizeof(a.datum) ) != 0)
+      return "datum";
+  #endif
+  #ifdef GPS_FIX_SATELLITES
+    SAME( satellites );
+  #endif
+  #if defined(GPS_FIX_DATE) | defined(GPS_FIX_TIME)
+    SAME( dateTime.seconds );
+    SAME( dateTime.minutes );
+    SAME( dateTime.hours );
+    SAME( dateTime.day );
+    SAME( dateTime.date );
+    SAME( dateTime.month );
+    SAME( dateTime.year );
+  #endif
+  #ifdef GPS_FIX_TIME
+    SAME( dateTime_cs );
+  #endif
+
+  #undef SAME
+
+  return (const char *) NULL;
+}
+
+//  Compare the fixes of one mode with the char mode.  Returns false
+//    if they are different.
+
+static bool checkMode
+  ( const workload_t & w, const char *mode,
+    const fixes_t & expected, const fixes_t & fixes )
+{
+  const char *member = (const char *) NULL;
+  size_t      i;
+
+  for (i=0; (i < expected.size()) && (i < fixes.size()); i++) {
+    member = differentMember( expected[i], fixes[i] );
+    if (member)
+      break;
+  }
+
+  bool same = !member && (expected.size() == fixes.size());
+
+  printf( "%-10s %-7s %7zu  ", w.name, mode, fixes.size() );
+  if (same)
+    printf( "same\n" );
+  else if (member)
+    printf( "DIFFERENT: fix %zu, %s\n", i, member );
+  else
+    printf( "DIFFERENT: %zu fixes, char mode has %zu\n",
+            fixes.size(), expected.size() );
+
+  return same;
+}
+
+static bool check( const workload_t & w )
+{
+  #ifdef NMEAGPS_IMPLICIT_MERGING
+    if (strcmp( w.name, "corrupted" ) == 0) {
+      workload_t truncated = { "truncated", std::string(), 0, false };
+      generateCorrupted( truncated, false );
+      return check( truncated );
+    }
+  #endif
+
+  fixes_t expected;
+  checkChars( w, expected );
+
+  bool ok = true;
+
+  fixes_t fixes;
+  checkBlocks( w, fixes, 0 );
+  ok &= checkMode( w, "bulk", expected, fixes );
+
+  static const uint32_t seeds[] = { 1, 2017, 65535 };
+  for (size_t s=0; s < sizeof(seeds)/sizeof(seeds[0]); s++) {
+    fixes.clear();
+    checkBlocks( w, fixes, seeds[s] );
+    ok &= checkMode( w, "split", expected, fixes );
+  }
+
+  return ok;
+}
+
+//--------------------------
+
+int main( int argc, char *argv[] )
+{
+  double      minTime  = 0.25;
+  const char *filter   = (const char *) NULL;
+  const char *jsonFile = (const char *) NULL;
+  bool        checking = false;
+
+  for (int i=1; i < argc; i++) {
+    if (strncmp( argv[i], "--min-time=", 11 ) == 0)
+      minTime = atof( &argv[i][11] );
+    else if (strncmp( argv[i], "--filter=", 9 ) == 0)
+      filter = &argv[i][9];
+    else if (strncmp( argv[i], "--json=", 7 ) == 0)
+      jsonFile = &argv[i][7];
+    else if (strcmp( argv[i], "--check" ) == 0)
+      checking = true;
+    else {
+      fprintf( stderr, "Usage: %s [--min-time=seconds] [--filter=text] [--json=file] [--check]\n",
+               argv[0] );
+      return 1;
+    }
+  }
+
+  std::vector<workload_t> workloads;
+  generateAll( workloads );
+
+  if (checking) {
+    printf( "ParserBenchmark --check: config %s\n", NEOGPS_CONFIG );
+    printf( "workload   mode      fixes\n" );
+
+    bool ok = true;
+    for (size_t i=0; i < workloads.size(); i++)
+      if (!filter || strstr( workloads[i].name, filter ))
+        ok &= check( workloads[i] );
+
+    return ok ? 0 : 1;
+  }
+
+  printf( "ParserBenchmark: config %s, %s, %s\n", NEOGPS_CONFIG,
+          #ifdef UBLOX_PARSER
+            "ubloxGPS",
+          #else
+            "NMEAGPS",
+          #endif
+          swarFields ? "SWAR fields" : "char fields" );
+  printf( "sizeof(parser) = %zu, sizeof(NMEAGPS) = %zu, sizeof(gps_fix) = %zu\n",
+          sizeof(parser_t), sizeof(NMEAGPS), sizeof(gps_fix) );
+  printf( "workload   mode      bytes  sentences   fixes   ns/byte  ns/sentence      fixes/s\n" );
+
+  std::vector<result_t> results;
+
+  for (size_t i=0; i < workloads.size(); i++) {
+    const workload_t & w = workloads[i];
+    if (filter && !strstr( w.name, filter ))
+      continue;
+
+    for (int mode=0; mode < MODES; mode++) {
+      result_t r = run( w, mode, minTime );
+      results.push_back( r );
+
+      printf( "%-10s %-5s %9zu %10zu %7zu %9.2f %12.1f %12.0f\n",
+              w.name, r.mode, w.data.size(), w.sentences, r.fixes,
+              nsPerByte( r ), nsPerSentence( r ), fixesPerSecond( r ) );
+      fflush( stdout );
+    }
+  }
+
+  if (jsonFile) {
+    FILE *f = fopen( jsonFile, "a" );
+    if (!f) {
+      perror( jsonFile );
+      return 1;
+    }
+    writeJSON( f, results );
+    fclose( f );
+  }
+
+  return 0;
+}
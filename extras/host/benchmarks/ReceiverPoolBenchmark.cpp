@@ -0,0 +1,182 @@
+//======================================================================
+//  Program: ReceiverPoolBenchmark.cpp
+//
+//  Description:  Measures how the fixes/second of a ReceiverPool
+//     scale from 1 worker thread to all cores.
+//
+//     Each device receives a synthetic stream of GGA, RMC, GSA and
+//     GSV sentences.  Every eighth device is "hot": it sends 10 times
+//     as many sentences as the others.
+//
+//     This is a host program.  It is built by the CMakeLists.txt in
+//     the top NeoGPS directory (see extras/host/README.md).
+//
+//  Usage:  ReceiverPoolBenchmark [devices [seconds-of-data [max-workers]]]
+//
+//     By default, the number of workers goes up to the number of cores.
+//
+//  License:
+//    Copyright (C) 2014-2017, SlashDevin
+//
+//    This file is part of NeoGPS
+//
+//    NeoGPS is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NeoGPS is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+//
+//======================================================================
+
+#include "ReceiverPool.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using NeoGPS::ReceiverPool;
+
+//--------------------------
+
+static void append( std::string & out, const char *body )
+{
+  uint8_t crc = 0;
+  for (const char *c = body; *c; c++)
+    crc ^= (uint8_t) *c;
+
+  char tail[8];
+  snprintf( tail, sizeof(tail), "*%02X\r\n", crc );
+
+  out += '$';
+  out += body;
+  out += tail;
+}
+
+//--------------------------
+//  One second of sentences, as from a typical receiver.
+
+static void appendInterval( std::string & out, size_t device, unsigned s )
+{
+  char body[120];
+
+  unsigned hh = (s / 3600) % 24, mm = (s / 60) % 60, ss = s % 60;
+  unsigned latMin = 1000 + (device * 37 + s) % 5000;
+
+  snprintf( body, sizeof(body),
+            "GPGGA,%02u%02u%02u.00,47%02u.%05u,N,00833.91590,E,1,8,1.01,499.6,M,48.0,M,,0",
+            hh, mm, ss, latMin / 100, (latMin % 100) * 1000 + s % 1000 );
+  append( out, body );
+
+  snprintf( body, sizeof(body),
+            "GPRMC,%02u%02u%02u.00,A,47%02u.%05u,N,00833.91590,E,0.004,77.52,091202,,,A",
+            hh, mm, ss, latMin / 100, (latMin % 100) * 1000 + s % 1000 );
+  append( out, body );
+
+  append( out, "GPGSA,A,3,23,29,07,08,09,18,26,28,,,,,1.94,1.18,1.54" );
+  append( out, "GPGSV,3,1,10,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36" );
+  append( out, "GPGSV,3,2,10,10,07,189,,05,05,220,,09,34,274,42,18,25,309,44" );
+  append( out, "GPGSV,3,3,10,26,82,187,47,28,43,056,46" );
+}
+
+//--------------------------
+
+static double run
+  ( size_t workers, const std::vector<std::string> & streams,
+    uint64_t & fixes, uint64_t & steals )
+{
+  const size_t devices = streams.size();
+  const size_t CHUNK   = 512; // about what one serial read returns
+
+  ReceiverPool pool( devices, workers );
+  std::vector<size_t> sent( devices, 0 );
+
+  fixes = 0;
+  gps_fix fix;
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+  bool more = true;
+  while (more) {
+    more = false;
+    for (size_t d=0; d < devices; d++) {
+      const std::string & s = streams[d];
+      if (sent[d] < s.size()) {
+        size_t len = s.size() - sent[d];
+        if (len > CHUNK)
+          len = CHUNK;
+        sent[d] += pool.ingest( d, (const uint8_t *) s.data() + sent[d], len );
+        more = true;
+      }
+
+      while (pool.read( d, fix ))
+        fixes++;
+    }
+  }
+
+  pool.drain();
+
+  std::chrono::steady_clock::time_point end =
+    std::chrono::steady_clock::now();
+
+  for (size_t d=0; d < devices; d++) {
+    while (pool.read( d, fix ))
+      fixes++;
+    fixes += pool.overruns( d );
+  }
+  steals = pool.steals();
+
+  return std::chrono::duration<double>( end - start ).count();
+
+} // run
+
+//--------------------------
+
+int main( int argc, char *argv[] )
+{
+  size_t   devices = (argc > 1) ? strtoul( argv[1], NULL, 0 ) : 64;
+  unsigned seconds = (argc > 2) ? strtoul( argv[2], NULL, 0 ) : 600;
+
+  std::vector<std::string> streams( devices );
+  size_t bytes = 0;
+  for (size_t d=0; d < devices; d++) {
+    unsigned intervals = ((d % 8) == 0) ? seconds * 10 : seconds;
+    for (unsigned s=0; s < intervals; s++)
+      appendInterval( streams[d], d, s );
+    bytes += streams[d].size();
+  }
+
+  size_t cores = (argc > 3) ? strtoul( argv[3], NULL, 0 )
+                            : std::thread::hardware_concurrency();
+  if (cores == 0)
+    cores = 1;
+
+  printf( "ReceiverPoolBenchmark: %zu devices, %zu bytes, %zu cores\n",
+          devices, bytes, cores );
+  printf( "workers      fixes    seconds      fixes/s   MB/s  speedup  steals\n" );
+
+  double baseRate = 0.0;
+  for (size_t w=1; w <= cores; w = (w < cores) && (2*w > cores) ? cores : 2*w) {
+    uint64_t fixes, steals;
+    double   elapsed = run( w, streams, fixes, steals );
+    double   rate    = fixes / elapsed;
+    if (w == 1)
+      baseRate = rate;
+
+    printf( "%7zu %10llu %10.3f %12.0f %6.1f %8.2f %7llu\n",
+            w, (unsigned long long) fixes, elapsed, rate,
+            bytes / elapsed / 1.0e6, rate / baseRate,
+            (unsigned long long) steals );
+  }
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Arduino.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+//----------------------------------------------------------------
+
+static uint64_t now_us()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t) ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+}
+
+static const uint64_t start_us = now_us();
+
+uint32_t micros()
+{
+  return (uint32_t) (now_us() - start_us);
+}
+
+uint32_t millis()
+{
+  return (uint32_t) ((now_us() - start_us) / 1000);
+}
+
+//----------------------------------------------------------------
+
+void delayMicroseconds( uint32_t us )
+{
+  struct timespec ts;
+  ts.tv_sec  = us / 1000000UL;
+  ts.tv_nsec = (us % 1000000UL) * 1000;
+  while ((nanosleep( &ts, &ts ) != 0) && (errno == EINTR))
+    ;
+}
+
+void delay( uint32_t ms )
+{
+  while (ms >= 1000) {
+    delayMicroseconds( 1000000UL );
+    ms -= 1000;
+  }
+  delayMicroseconds( ms * 1000UL );
+}
+
+void yield()
+{
+  sched_yield();
+}
+
+//----------------------------------------------------------------
+
+size_t Stream::readBytes( uint8_t *buffer, size_t length )
+{
+  size_t count = 0;
+  while ((count < length) && (available() > 0)) {
+    int c = read();
+    if (c < 0)
+      break;
+    buffer[ count++ ] = c;
+  }
+  return count;
+
+} // readBytes
@@ -0,0 +1,93 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+//------------------------------------------------------------------------
+// A minimal Arduino compatibility layer, so the NeoGPS sources can be
+// built for a host (e.g., Linux).  Only the parts of the Arduino core
+// that NeoGPS uses are provided.
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARDUINO
+  #define ARDUINO 10808 // a recent IDE, for CONST_CLASS_DATA
+#endif
+
+//------------------------------------------------------------------------
+// There is only one address space, so PROGMEM data is accessed directly.
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)  (*(const uint8_t  *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)   (*(const void * const *)(addr))
+
+#define strcpy_P  strcpy
+#define strncpy_P strncpy
+#define strlen_P  strlen
+#define strcmp_P  strcmp
+#define memcpy_P  memcpy
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+//------------------------------------------------------------------------
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#ifndef PI
+  #define PI         3.1415926535897932384626433832795
+#endif
+#define HALF_PI      1.5707963267948966192313216916398
+#define TWO_PI       6.283185307179586476925286766559
+#define DEG_TO_RAD   0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+//------------------------------------------------------------------------
+// Time is measured from a monotonic clock, starting when the program
+// starts.  Like the Arduino core, micros() wraps after ~71 minutes.
+
+extern uint32_t micros();
+extern uint32_t millis();
+extern void     delay( uint32_t ms );
+extern void     delayMicroseconds( uint32_t us );
+
+// There are no interrupts.  The parser and reader may be different
+// threads, but the fix buffer is already safe for one of each (see
+// NEOGPS_ATOMIC_INDICES in NeoGPS_cfg.h).
+
+inline void noInterrupts() {}
+inline void interrupts  () {}
+
+extern void yield();
+
+#include "Stream.h"
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef PRINT_H
+#define PRINT_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class __FlashStringHelper;
+
+//------------------------------------------------------------------------
+// The Arduino Print class.  Numbers are formatted the same way as the
+// Arduino core.  FilePrint and BufferPrint (extras/host/HostPrint.h)
+// write to a FILE * or to memory.
+
+class Print
+{
+public:
+  virtual ~Print() {};
+
+  virtual size_t write( uint8_t c ) = 0;
+  virtual size_t write( const uint8_t *buffer, size_t size );
+          size_t write( const char *str )
+            { return (str) ? write( (const uint8_t *) str, strlen(str) ) : 0; };
+          size_t write( const char *buffer, size_t size )
+            { return write( (const uint8_t *) buffer, size ); };
+
+  virtual void flush() {};
+
+  size_t print( const __FlashStringHelper *str );
+  size_t print( const char str[] );
+  size_t print( char c );
+  size_t print( unsigned char n, int base = 10 );
+  size_t print( int           n, int base = 10 );
+  size_t print( unsigned int  n, int base = 10 );
+  size_t print( long          n, int base = 10 );
+  size_t print( unsigned long n, int base = 10 );
+  size_t print( double        n, int digits = 2 );
+
+  size_t println();
+  size_t println( const __FlashStringHelper *str );
+  size_t println( const char str[] );
+  size_t println( char c );
+  size_t println( unsigned char n, int base = 10 );
+  size_t println( int           n, int base = 10 );
+  size_t println( unsigned int  n, int base = 10 );
+  size_t println( long          n, int base = 10 );
+  size_t println( unsigned long n, int base = 10 );
+  size_t println( double        n, int digits = 2 );
+
+private:
+  size_t printNumber( unsigned long n, uint8_t base );
+  size_t printFloat ( double n, uint8_t digits );
+};
+
+#endif
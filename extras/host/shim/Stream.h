@@ -0,0 +1,41 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Print.h"
+
+//------------------------------------------------------------------------
+// The character input methods of the Arduino Stream class.
+// NeoGPS::MappedStream (extras/host) implements them for files,
+// FIFOs, ptys and serial devices.
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  //  Read up to /length/ characters that are already available.
+  size_t readBytes( uint8_t *buffer, size_t length );
+  size_t readBytes( char    *buffer, size_t length )
+    { return readBytes( (uint8_t *) buffer, length ); };
+};
+
+#endif
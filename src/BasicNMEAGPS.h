@@ -0,0 +1,120 @@
+#ifndef BASICNMEAGPS_H
+#define BASICNMEAGPS_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NMEAGPS_cfg.h"
+
+#ifndef NMEAGPS_BASIC_PARSER
+  #error NMEAGPS_BASIC_PARSER must be defined in NMEAGPS_cfg.h to use BasicNMEAGPS!
+#endif
+
+#include "NMEAGPS.h"
+
+//------------------------------------------------------
+//  The default configuration for BasicNMEAGPS: all the sentences and
+//    fields that are enabled in the configuration files, and the usual
+//    LAST_SENTENCE_IN_INTERVAL.  Derive from this and redefine the
+//    members to change them.
+
+struct NMEAGPS_Config
+{
+  //  The sentence types that are parsed.  Other types are still
+  //    recognized (and counted), but their fields are skipped.  Only
+  //    types that are enabled in NMEAGPS_cfg.h can be parsed.
+  static const uint32_t SENTENCES = 0xFFFFFFFFUL;
+
+  //  The field converters that are used (NMEAGPS_CONVERTER bits).  The
+  //    fields of other converters are skipped.  Only converters for
+  //    members enabled in GPSfix_cfg.h can be used.
+  static const uint32_t CONVERTERS = 0xFFFFFFFFUL;
+
+  //  The sentence that ends an update interval.
+  static const NMEAGPS::nmea_msg_t LAST_SENTENCE = LAST_SENTENCE_IN_INTERVAL;
+};
+
+//------------------------------------------------------
+//
+//  A parser with its own compile-time configuration.  The global
+//  configuration files decide which sentences and fix members can be
+//  parsed at all.  Each BasicNMEAGPS instance can parse fewer sentences
+//  and fields, and end its intervals with a different sentence, so one
+//  program can have a minimal parser for one receiver and a full parser
+//  for another:
+//
+//    struct RMConly : NMEAGPS_Config
+//    {
+//      static const uint32_t SENTENCES =
+//        NMEAGPS_SENTENCE( NMEAGPS::NMEA_RMC );
+//      static const uint32_t CONVERTERS =
+//        NMEAGPS_CONVERTER( NMEAGPS::FIELD_FIX  ) |
+//        NMEAGPS_CONVERTER( NMEAGPS::FIELD_TIME ) |
+//        NMEAGPS_CONVERTER( NMEAGPS::FIELD_LAT  ) |
+//        NMEAGPS_CONVERTER( NMEAGPS::FIELD_NS   ) |
+//        NMEAGPS_CONVERTER( NMEAGPS::FIELD_LON  ) |
+//        NMEAGPS_CONVERTER( NMEAGPS::FIELD_EW   );
+//    };
+//    BasicNMEAGPS<RMConly> tracker;  // just the RMC status, time and location
+//    NMEAGPS               survey;   // everything in NMEAGPS_cfg.h
+//
+//  The Config is used once per sentence, when its type has been
+//  received: /parsedFields/ selects the fields, and the decoder skips
+//  the others without calling /parseField/.  The characters of the
+//  parsed fields cost the same as in NMEAGPS.
+//
+//  NOTE: This is not a complete compile-time specialization.
+//    /parsedFields/ and /intervalCompleted/ are virtual (see
+//    NMEAGPS_BASIC_PARSER), and /parseField/ is the same for all
+//    instances.  gps_fix members, merging and the fix buffer size are
+//    still configured by GPSfix_cfg.h and NMEAGPS_cfg.h, because they
+//    determine the layout of gps_fix and NMEAGPS.
+
+template <class Config>
+class BasicNMEAGPS : public NMEAGPS
+{
+    BasicNMEAGPS & operator =( const BasicNMEAGPS & );
+    BasicNMEAGPS( const BasicNMEAGPS & );
+
+public:
+
+    BasicNMEAGPS() {};
+
+    //  True if /msg/ is parsed by this configuration.
+    static bool parses( nmea_msg_t msg )
+      {
+        return (Config::SENTENCES == 0xFFFFFFFFUL) ||
+               ((msg < 32) && (Config::SENTENCES & NMEAGPS_SENTENCE( msg )));
+      }
+
+protected:
+
+    uint32_t parsedFields() const
+      {
+        if (!parses( nmeaMessage ))
+          return 0;
+        return standardFields( Config::CONVERTERS );
+      }
+
+    bool intervalCompleted() const
+      {
+        return (nmeaMessage == Config::LAST_SENTENCE);
+      }
+
+} NEOGPS_PACKED;
+
+#endif
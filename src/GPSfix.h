@@ -172,6 +172,17 @@ public:
     float    heading   () const { return hdg.float_00(); };
   #endif
 
+  //--------------------------------------------------------
+  // The direction the vessel is pointing (e.g., from HDT), which
+  //   may be different from the direction of travel (heading, above).
+
+  #ifdef GPS_FIX_TRUE_HEADING
+    whole_frac    trueHdg; //  .01 degrees
+
+    uint16_t true_heading_cd() const { return trueHdg.int16_00(); };
+    float    true_heading   () const { return trueHdg.float_00(); };
+  #endif
+
   //--------------------------------------------------------
   // Dilution of Precision is a measure of the current satellite
   // constellation geometry WRT how 'good' it is for determining a
@@ -179,7 +190,7 @@ public:
   // other factors that may be internal to the receiver.
   // It _cannot_ be used to determine position accuracy in meters.
   // Instead, use the LAT/LON/ALT error in cm members, which are
-  //   populated by GST sentences.
+  //   populated by GST and GBS sentences.
 
   #ifdef GPS_FIX_HDOP
     uint16_t           hdop; // Horizontal Dilution of Precision x 1000
@@ -233,6 +244,13 @@ public:
     float   geoidHeight   () const { return geoidHt.float_00(); };
   #endif
 
+  //--------------------------------------------------------
+  // The local datum code of the position (e.g., "W84"), from DTM.
+  //   This is NUL-terminated.
+  #ifdef GPS_FIX_DATUM
+    char          datum[4];
+  #endif
+
   //--------------------------------------------------------
   // Number of satellites used to calculate a fix.
   #ifdef GPS_FIX_SATELLITES
@@ -315,6 +333,10 @@ public:
       bool heading NEOGPS_BF(1);
     #endif
 
+    #ifdef GPS_FIX_TRUE_HEADING
+      bool trueHeading NEOGPS_BF(1);
+    #endif
+
     #ifdef GPS_FIX_SATELLITES
       bool satellites NEOGPS_BF(1);
     #endif
@@ -357,6 +379,10 @@ public:
       bool geoidHeight NEOGPS_BF(1);
     #endif
 
+    #ifdef GPS_FIX_DATUM
+      bool datum NEOGPS_BF(1);
+    #endif
+
     // Initialize all flags to false
     void init()
       {
@@ -408,6 +434,10 @@ public:
       hdg.init();
     #endif
 
+    #ifdef GPS_FIX_TRUE_HEADING
+      trueHdg.init();
+    #endif
+
     #ifdef GPS_FIX_HDOP
       hdop = 0;
     #endif
@@ -441,6 +471,10 @@ public:
       geoidHt.init();
     #endif
 
+    #ifdef GPS_FIX_DATUM
+      datum[0] = '\0';
+    #endif
+
     #ifdef GPS_FIX_SATELLITES
       satellites = 0;
     #endif
@@ -511,6 +545,11 @@ public:
         hdg = r.hdg;
     #endif
 
+    #ifdef GPS_FIX_TRUE_HEADING
+      if (r.valid.trueHeading)
+        trueHdg = r.trueHdg;
+    #endif
+
     #ifdef GPS_FIX_SPEED
       if (r.valid.speed)
         spd = r.spd;
@@ -579,6 +618,13 @@ public:
         geoidHt = r.geoidHt;
     #endif
 
+    #ifdef GPS_FIX_DATUM
+      if (r.valid.datum) {
+        for (uint8_t i=0; i < sizeof(datum); i++)
+          datum[i] = r.datum[i];
+      }
+    #endif
+
     // Update all the valid flags
     valid |= r.valid;
 
@@ -41,6 +41,7 @@
 #define GPS_FIX_SPEED
 //#define GPS_FIX_VELNED
 #define GPS_FIX_HEADING
+//#define GPS_FIX_TRUE_HEADING
 #define GPS_FIX_SATELLITES
 //#define GPS_FIX_HDOP
 //#define GPS_FIX_VDOP
@@ -52,5 +53,6 @@
 //#define GPS_FIX_HDG_ERR
 //#define GPS_FIX_TIME_ERR
 //#define GPS_FIX_GEOID_HEIGHT
+//#define GPS_FIX_DATUM
 
 #endif
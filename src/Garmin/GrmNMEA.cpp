@@ -72,24 +72,54 @@ const NMEAGPS::msg_table_t GarminNMEA::garmin_msg_table __PROGMEM =
 
 //----------------------------------------------------------------
 
+const uint8_t GarminNMEA::pgrmf_fields[] __PROGMEM =
+  {
+    FIELD_SKIP, FIELD_SKIP, FIELD_SKIP,
+    FIELD_DDMMYY,
+    FIELD_TIME,
+    FIELD_LEAP_SECONDS,
+    FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+    FIELD_SKIP,         // fix mode, not needed because the next field sets status
+    FIELD_FIX,
+    FIELD_SPEED_KPH,
+    FIELD_HEADING,
+    FIELD_PDOP
+    // TDOP is not yet supported
+  };
+
+const NMEAGPS::schema_t GarminNMEA::pgrmf_schema __PROGMEM =
+  { sizeof(pgrmf_fields), pgrmf_fields };
+
+//----------------------------------------------------------------
+
+uint32_t GarminNMEA::parsedFields() const
+{
+  if (nmeaMessage == PGRMF)
+    return schemaMask( &pgrmf_schema );
+
+  return NMEAGPS::parsedFields();
+
+} // parsedFields
+
+//----------------------------------------------------------------
+
+const NMEAGPS::schema_t *GarminNMEA::sentenceSchema() const
+{
+  if (nmeaMessage == PGRMF)
+    return &pgrmf_schema;
+
+  return NMEAGPS::sentenceSchema();
+
+} // sentenceSchema
+
+//----------------------------------------------------------------
+
 bool GarminNMEA::parseF( char chr )
 {
-  #ifdef GARMINGPS_PARSE_F
-    switch (fieldIndex) {
-        case 3: return parseDDMMYY( chr );
-        case 4: return parseTime( chr );
-        case 5: return parseLeapSeconds( chr );  // <--  you will write this
-        PARSE_LOC(6);
-        //case 10: return parseFix( char ); // not needed, because next field sets status
-        case 11: return parseFix( chr );
-        case 12: return parseSpeedKph( chr );
-        case 13: return parseHeading( chr );
-        case 14: return parsePDOP( chr );
-        //case 15: return parseTDOP( chr ); // not yet supported
-    }
-  #endif
+  if (_converter == FIELD_LEAP_SECONDS)
+    return parseLeapSeconds( chr );
 
-  return true;
+  return parseConverter( _converter, chr );
 
 } // parseF
 
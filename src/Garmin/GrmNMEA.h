@@ -70,7 +70,9 @@ public:
     static const nmea_msg_t PGRM_LAST_MSG  = (nmea_msg_t) (PGRM_END  -1);
 
 protected:
-    bool parseField( char chr );
+    bool     parseField( char chr );
+    uint32_t parsedFields() const;
+    const schema_t *sentenceSchema() const;
 
     bool parseMfrID( char chr )
       { bool ok;
@@ -87,6 +89,14 @@ protected:
 
     bool parseLeapSeconds( char chr );
 
+    //  PGRM converters, in addition to the NMEAGPS converters
+    enum grm_field_t {
+      FIELD_LEAP_SECONDS = FIELD_DERIVED
+    };
+
+    static const uint8_t  pgrmf_fields[] __PROGMEM;
+    static const schema_t pgrmf_schema   __PROGMEM;
+
     static const msg_table_t garmin_msg_table __PROGMEM;
 
     NMEAGPS_VIRTUAL const msg_table_t *msg_table() const
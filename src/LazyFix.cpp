@@ -0,0 +1,443 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "LazyFix.h"
+
+#ifdef NMEAGPS_LAZY_FIX
+
+#include "NMEAframe.h"
+
+#include <string.h>
+
+#define FIELD(i) (1UL << (i))
+#define PART(p)  (1UL << (p))
+
+//----------------------------------------------------------------
+//  The parts of a lazy_fix that have a valid flag set.
+
+static uint32_t lazyParts( const gps_fix::valid_t & valid )
+{
+  uint32_t parts = 0;
+
+  if (valid.status)
+    parts |= PART(lazy_fix::PART_STATUS);
+  #ifdef GPS_FIX_DATE
+    if (valid.date)
+      parts |= PART(lazy_fix::PART_DATE);
+  #endif
+  #ifdef GPS_FIX_TIME
+    if (valid.time)
+      parts |= PART(lazy_fix::PART_TIME);
+  #endif
+  #if defined( GPS_FIX_LOCATION ) | defined( GPS_FIX_LOCATION_DMS )
+    if (valid.location)
+      parts |= PART(lazy_fix::PART_LOCATION);
+  #endif
+  #ifdef GPS_FIX_ALTITUDE
+    if (valid.altitude)
+      parts |= PART(lazy_fix::PART_ALTITUDE);
+  #endif
+  #ifdef GPS_FIX_SPEED
+    if (valid.speed)
+      parts |= PART(lazy_fix::PART_SPEED);
+  #endif
+  #ifdef GPS_FIX_HEADING
+    if (valid.heading)
+      parts |= PART(lazy_fix::PART_HEADING);
+  #endif
+  #ifdef GPS_FIX_TRUE_HEADING
+    if (valid.trueHeading)
+      parts |= PART(lazy_fix::PART_TRUE_HEADING);
+  #endif
+  #ifdef GPS_FIX_SATELLITES
+    if (valid.satellites)
+      parts |= PART(lazy_fix::PART_SATELLITES);
+  #endif
+  #ifdef GPS_FIX_HDOP
+    if (valid.hdop)
+      parts |= PART(lazy_fix::PART_HDOP);
+  #endif
+  #ifdef GPS_FIX_VDOP
+    if (valid.vdop)
+      parts |= PART(lazy_fix::PART_VDOP);
+  #endif
+  #ifdef GPS_FIX_PDOP
+    if (valid.pdop)
+      parts |= PART(lazy_fix::PART_PDOP);
+  #endif
+  #ifdef GPS_FIX_LAT_ERR
+    if (valid.lat_err)
+      parts |= PART(lazy_fix::PART_LAT_ERR);
+  #endif
+  #ifdef GPS_FIX_LON_ERR
+    if (valid.lon_err)
+      parts |= PART(lazy_fix::PART_LON_ERR);
+  #endif
+  #ifdef GPS_FIX_ALT_ERR
+    if (valid.alt_err)
+      parts |= PART(lazy_fix::PART_ALT_ERR);
+  #endif
+  #ifdef GPS_FIX_GEOID_HEIGHT
+    if (valid.geoidHeight)
+      parts |= PART(lazy_fix::PART_GEOID_HEIGHT);
+  #endif
+  #ifdef GPS_FIX_DATUM
+    if (valid.datum)
+      parts |= PART(lazy_fix::PART_DATUM);
+  #endif
+
+  return parts;
+
+} // lazyParts
+
+//----------------------------------------------------------------
+
+size_t NMEAGPS::handle
+  ( const uint8_t *buf, size_t len,
+    lazy_fix & lazy, lazy_handler_t handler, void *context )
+{
+  const uint8_t *ptr = buf;
+  const uint8_t *end = buf + len;
+
+  lazy._parser = this;
+
+  while (ptr < end) {
+
+    // Only NMEA sentences are handled.  Skip everything up to the
+    //   next '$'.
+    const uint8_t *dollar = (const uint8_t *) memchr( ptr, '$', end-ptr );
+    if (dollar == (const uint8_t *) NULL)
+      dollar = end;
+
+    if (dollar != ptr) {
+      #ifdef NMEAGPS_STATS
+        statistics.chars += (dollar - ptr);
+      #endif
+      #ifdef NMEAGPS_EXTENDED_STATS
+        for (const uint8_t *c = ptr; c < dollar; c++)
+          if ((*c != '\r') && (*c != '\n'))
+            statistics.discarded++;
+      #endif
+
+      ptr = dollar;
+      continue;
+    }
+
+    // Check the whole sentence before recognizing it.
+    NeoGPS::NMEAframe          frame;
+    NeoGPS::NMEAframe::frame_t scanned = frame.scan( ptr, end-ptr );
+
+    if (scanned == NeoGPS::NMEAframe::FRAME_INCOMPLETE) {
+      // Wait for the rest of it, unless it can't be a sentence.
+      const uint8_t *next = (const uint8_t *) memchr( ptr+1, '$', end-ptr-1 );
+      if (next == (const uint8_t *) NULL) {
+        if (end-ptr < NeoGPS::NMEAframe::MAX_LENGTH)
+          break;
+        next = end;
+      }
+      #ifdef NMEAGPS_STATS
+        statistics.chars += (next - ptr);
+      #endif
+
+      ptr = next;
+      continue;
+    }
+
+    if (scanned == NeoGPS::NMEAframe::FRAME_BAD_CRC) {
+      #ifdef NMEAGPS_STATS
+        statistics.chars += frame.length;
+        statistics.errors++;
+      #endif
+      #ifdef NMEAGPS_EXTENDED_STATS
+        statistics.message( frameMessage( ptr, frame ) ).errors++;
+      #endif
+
+      ptr += frame.length;
+      continue;
+    }
+
+    //  Only the sentences from this block are merged into /lazy/.
+    m_fix.valid.init();
+
+    decode_t res      = DECODE_CHR_OK;
+    bool     deferred = false;
+
+    if (frame.allCommas() && (frame.commas > 0)) {
+
+      res = decodeHeader( ptr, frame );
+
+      if (rxState == NMEA_RECEIVING_DATA) {
+        //  A sentence that fails validation must be rejected before
+        //    the interval is complete, so it is parsed now.
+        const schema_t *schema = schemaFor( nmeaMessage );
+        deferred = (schema != (const schema_t *) NULL) &&
+                   !(validateChars() | validateFields());
+        #if defined(NMEAGPS_DERIVED_TYPES) | defined(NMEAGPS_BASIC_PARSER)
+          //  A derived class may parse more (or fewer) fields.
+          if (deferred && (parsedFields() != schemaMask( schema )))
+            deferred = false;
+        #endif
+
+        if (deferred) {
+          // Just remember where it is.
+          if (lazy._count == lazy_fix::MAX_SENTENCES)
+            lazy.release();
+
+          lazy_fix::slice_t & slice = lazy._slice[ lazy._count++ ];
+          slice.chars = ptr;
+          slice.frame = frame;
+          slice.msg   = nmeaMessage;
+
+          #ifdef NMEAGPS_STATS
+            statistics.chars += frame.length - frame.fieldStart( 1 );
+          #endif
+          frameOk( frame );
+          res = DECODE_COMPLETED;
+
+        } else {
+          // GSA, GSV and derived sentences are parsed now, too.
+          res = decodeFields( ptr, frame );
+        }
+      }
+
+    } else {
+      // Too many fields for NMEAframe, use the FSM
+      for (uint8_t i=0; i < frame.length; i++)
+        res = decode( ptr[i] );
+    }
+
+    ptr += frame.length;
+
+    if (res == DECODE_COMPLETED) {
+
+      if (!deferred) {
+        // Convert the earlier sentences for the same parts first,
+        //   so they are merged in order.
+        uint32_t parts = lazyParts( m_fix.valid );
+        for (uint8_t p=0; p < lazy_fix::PART_COUNT; p++)
+          if ((parts & PART(p)) && (lazy._next[p] < lazy._count))
+            convertLazy( lazy, p );
+
+        lazy._fix |= m_fix;
+      }
+
+      if ((currentMerging() == NO_MERGING) || intervalComplete()) {
+        if (intervalComplete())
+          endInterval();
+
+        if (handler)
+          handler( lazy, context );
+        lazy.init();
+      }
+    }
+  }
+
+  //  The rest of the interval may be in the next block.
+  lazy.release();
+
+  return ptr - buf;
+
+} // handle
+
+//----------------------------------------------------------------
+//  This is only called between sentences, so the FSM is idle.
+
+void NMEAGPS::convertLazy( lazy_fix & lazy, uint8_t part )
+{
+  uint32_t converters;
+
+  switch (part) {
+    case lazy_fix::PART_STATUS:
+      converters = FIELD(FIELD_FIX) | FIELD(FIELD_GNS_MODE);
+      break;
+    #ifdef GPS_FIX_DATE
+      case lazy_fix::PART_DATE:
+        converters = FIELD(FIELD_DDMMYY) | FIELD(FIELD_ZDA_DATE);
+        break;
+    #endif
+    #ifdef GPS_FIX_TIME
+      case lazy_fix::PART_TIME:
+        converters = FIELD(FIELD_TIME);
+        break;
+    #endif
+    #if defined( GPS_FIX_LOCATION ) | defined( GPS_FIX_LOCATION_DMS )
+      case lazy_fix::PART_LOCATION:
+        converters = FIELD(FIELD_LAT) | FIELD(FIELD_NS) |
+                     FIELD(FIELD_LON) | FIELD(FIELD_EW);
+        break;
+    #endif
+    #ifdef GPS_FIX_ALTITUDE
+      case lazy_fix::PART_ALTITUDE:
+        converters = FIELD(FIELD_ALT);
+        break;
+    #endif
+    #ifdef GPS_FIX_SPEED
+      case lazy_fix::PART_SPEED:
+        converters = FIELD(FIELD_SPEED) | FIELD(FIELD_SPEED_KPH);
+        break;
+    #endif
+    #ifdef GPS_FIX_HEADING
+      case lazy_fix::PART_HEADING:
+        converters = FIELD(FIELD_HEADING);
+        break;
+    #endif
+    #ifdef GPS_FIX_TRUE_HEADING
+      case lazy_fix::PART_TRUE_HEADING:
+        converters = FIELD(FIELD_TRUE_HEADING);
+        break;
+    #endif
+    #ifdef GPS_FIX_SATELLITES
+      case lazy_fix::PART_SATELLITES:
+        converters = FIELD(FIELD_SATELLITES);
+        break;
+    #endif
+    #ifdef GPS_FIX_HDOP
+      case lazy_fix::PART_HDOP:
+        converters = FIELD(FIELD_HDOP);
+        break;
+    #endif
+    #ifdef GPS_FIX_VDOP
+      case lazy_fix::PART_VDOP:
+        converters = FIELD(FIELD_VDOP);
+        break;
+    #endif
+    #ifdef GPS_FIX_PDOP
+      case lazy_fix::PART_PDOP:
+        converters = FIELD(FIELD_PDOP);
+        break;
+    #endif
+    #ifdef GPS_FIX_LAT_ERR
+      case lazy_fix::PART_LAT_ERR:
+        converters = FIELD(FIELD_LAT_ERR);
+        break;
+    #endif
+    #ifdef GPS_FIX_LON_ERR
+      case lazy_fix::PART_LON_ERR:
+        converters = FIELD(FIELD_LON_ERR);
+        break;
+    #endif
+    #ifdef GPS_FIX_ALT_ERR
+      case lazy_fix::PART_ALT_ERR:
+        converters = FIELD(FIELD_ALT_ERR);
+        break;
+    #endif
+    #ifdef GPS_FIX_GEOID_HEIGHT
+      case lazy_fix::PART_GEOID_HEIGHT:
+        converters = FIELD(FIELD_GEOID_HEIGHT);
+        break;
+    #endif
+    #ifdef GPS_FIX_DATUM
+      case lazy_fix::PART_DATUM:
+        converters = FIELD(FIELD_DATUM);
+        break;
+    #endif
+    default:
+      converters = 0;
+      break;
+  }
+
+  #ifdef NMEAGPS_RUNTIME_PROFILE
+    converters &= _converters; // just the members in the profile
+  #endif
+
+  //  The current fix may be a GSA or GSV that is about to be merged.
+
+  gps_fix    current = m_fix;
+  nmea_msg_t msg     = nmeaMessage;
+
+  for (uint8_t s=lazy._next[ part ]; s < lazy._count; s++) {
+    const lazy_fix::slice_t & slice  = lazy._slice[ s ];
+    const NeoGPS::NMEAframe & frame  = slice.frame;
+    const uint8_t            *chars  = slice.chars;
+    const schema_t           *schema = schemaFor( slice.msg );
+
+    //  The fields of this sentence that set this part
+    uint8_t        count  = pgm_read_byte( &schema->count );
+    const uint8_t *fields = (const uint8_t *) pgm_read_ptr( &schema->fields );
+    uint32_t       wanted = 0;
+
+    for (uint8_t f=1; f < count; f++) {
+      uint8_t field = pgm_read_byte( &fields[f] );
+      if ((field < FIELD_DERIVED) && (converters & FIELD(field)))
+        wanted |= FIELD(f);
+    }
+    if (!wanted)
+      continue;
+
+    //  Start the fields again, like /headerReceived/.
+    m_fix.valid.init();
+    shadowFix();
+    nmeaMessage = slice.msg;
+    rxState     = NMEA_RECEIVING_DATA;
+    comma_needed( false );
+
+    for (uint8_t f=1; (f <= frame.commas) && (wanted >> f); f++) {
+      if (!(wanted & FIELD(f)))
+        continue;
+
+      uint8_t field = pgm_read_byte( &fields[f] );
+      uint8_t i     = frame.fieldStart( f );
+      uint8_t end   = frame.fieldEnd  ( f );
+      fieldIndex = f;
+      chrCount   = 0;
+
+      #ifdef NMEAGPS_SWAR_FIELDS
+        if ((end != frame.crcIndex) &&
+            parseSlice( &chars[i], end - i, frame.length - i ))
+          continue;
+      #endif
+
+      for (; i < end; i++) {
+        if (!parseConverter( field, chars[i] ))
+          sentenceInvalid();
+        if (rxState != NMEA_RECEIVING_DATA)
+          break;
+        chrCount++;
+      }
+
+      if (rxState != NMEA_RECEIVING_DATA)
+        break;
+
+      if (end == frame.crcIndex) {
+        //  Like /sentenceOk/, after the CRC chars
+        if (comma_needed()) {
+          comma_needed( false );
+          chrCount = 2;
+          parseConverter( field, ',' );
+        }
+        break;
+      }
+
+      if (!parseConverter( field, ',' ))
+        sentenceInvalid();
+      comma_needed( false );
+    }
+
+    //  A rejected sentence does not change this part.
+    if (rxState == NMEA_RECEIVING_DATA)
+      lazy._fix |= m_fix;
+  }
+
+  lazy._next[ part ] = lazy._count;
+
+  m_fix       = current;
+  nmeaMessage = msg;
+  reset();
+
+} // convertLazy
+
+#endif
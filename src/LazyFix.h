@@ -0,0 +1,281 @@
+#ifndef LAZYFIX_H
+#define LAZYFIX_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NMEAGPS.h"
+#include "NMEAframe.h"
+
+#ifdef NMEAGPS_LAZY_FIX
+
+//------------------------------------------------------
+//
+// A fix whose members are converted when they are used.
+//
+// NMEAGPS::handle( buf, len, lazy, handler ) checks and recognizes
+// each sentence in the block, but it does not parse the fields of
+// the standard sentences (GGA, RMC, etc.).  Instead, the /lazy_fix/
+// remembers where each sentence is in the block.  When an accessor
+// is called (e.g., latitudeL()), the fields for that part of the fix
+// are converted from all the sentences of the update interval, and
+// merged just like EXPLICIT_MERGING.  The parts that are never used
+// are never converted.
+//
+// GSA, GSV and the sentences of derived classes (e.g., PUBX) are
+// always parsed, because they also update the satellite information.
+// If NMEAGPS_VALIDATE_CHARS or _FIELDS is enabled, all sentences are
+// parsed, so that a bad sentence is rejected before the end of the
+// interval.
+//
+// The accessors can only be used in the /handler/, because the
+// characters are still in the block.  If the interval is not complete
+// at the end of the block, its sentences are converted before handle
+// returns.
+//
+// Each accessor has the same name and type as the gps_fix member or
+// method.  Call /convert/ to check a validity flag:
+//
+//     if (lazy.convert( lazy_fix::PART_LOCATION ).valid.location)
+//       DEBUG_PORT.println( lazy.latitudeL() );
+//
+// Call /materialize/ to convert all the parts into a normal gps_fix.
+
+class lazy_fix
+{
+  lazy_fix & operator =( const lazy_fix & );
+  lazy_fix( const lazy_fix & );
+
+public:
+
+  //  The parts of a fix that are set by the standard sentences.
+  //    Each one has a validity flag in gps_fix::valid_t.
+
+  enum part_t
+    {
+      PART_STATUS,
+      #ifdef GPS_FIX_DATE
+        PART_DATE,
+      #endif
+      #ifdef GPS_FIX_TIME
+        PART_TIME,
+      #endif
+      #if defined( GPS_FIX_LOCATION ) | defined( GPS_FIX_LOCATION_DMS )
+        PART_LOCATION,
+      #endif
+      #ifdef GPS_FIX_ALTITUDE
+        PART_ALTITUDE,
+      #endif
+      #ifdef GPS_FIX_SPEED
+        PART_SPEED,
+      #endif
+      #ifdef GPS_FIX_HEADING
+        PART_HEADING,
+      #endif
+      #ifdef GPS_FIX_TRUE_HEADING
+        PART_TRUE_HEADING,
+      #endif
+      #ifdef GPS_FIX_SATELLITES
+        PART_SATELLITES,
+      #endif
+      #ifdef GPS_FIX_HDOP
+        PART_HDOP,
+      #endif
+      #ifdef GPS_FIX_VDOP
+        PART_VDOP,
+      #endif
+      #ifdef GPS_FIX_PDOP
+        PART_PDOP,
+      #endif
+      #ifdef GPS_FIX_LAT_ERR
+        PART_LAT_ERR,
+      #endif
+      #ifdef GPS_FIX_LON_ERR
+        PART_LON_ERR,
+      #endif
+      #ifdef GPS_FIX_ALT_ERR
+        PART_ALT_ERR,
+      #endif
+      #ifdef GPS_FIX_GEOID_HEIGHT
+        PART_GEOID_HEIGHT,
+      #endif
+      #ifdef GPS_FIX_DATUM
+        PART_DATUM,
+      #endif
+      PART_COUNT
+    };
+
+  //  Sentences that are not converted yet.  When there are more
+  //    in one interval, the first ones are converted to make room.
+  CONST_CLASS_DATA uint8_t MAX_SENTENCES = 16;
+
+  lazy_fix() : _parser( (NMEAGPS *) NULL ) { init(); };
+
+  //  Forget the current interval.
+  void init()
+    {
+      _fix.init();
+      _count = 0;
+      for (uint8_t p=0; p < PART_COUNT; p++)
+        _next[p] = 0;
+    }
+
+  //  Convert one part of the fix, and return the whole fix.  Only
+  //    that part (and any part that was already converted) is valid.
+  const gps_fix & convert( part_t part )
+    {
+      if (_next[ part ] < _count)
+        _parser->convertLazy( *this, part );
+      return _fix;
+    }
+
+  //  Convert all the parts.
+  const gps_fix & materialize()
+    {
+      for (uint8_t p=0; p < PART_COUNT; p++)
+        convert( (part_t) p );
+      return _fix;
+    }
+
+  //------------------------------------------------------
+  //  Accessors, like the gps_fix members.
+
+  gps_fix::status_t status() { return convert( PART_STATUS ).status; };
+
+  #if defined(GPS_FIX_DATE) & defined(GPS_FIX_TIME)
+    const NeoGPS::time_t & dateTime()
+      {
+        convert( PART_DATE );
+        return convert( PART_TIME ).dateTime;
+      }
+  #elif defined(GPS_FIX_DATE)
+    const NeoGPS::time_t & dateTime() { return convert( PART_DATE ).dateTime; };
+  #elif defined(GPS_FIX_TIME)
+    const NeoGPS::time_t & dateTime() { return convert( PART_TIME ).dateTime; };
+  #endif
+
+  #ifdef GPS_FIX_TIME
+    uint8_t dateTime_cs() { return convert( PART_TIME ).dateTime_cs; };
+  #endif
+
+  #ifdef GPS_FIX_LOCATION
+    const NeoGPS::Location_t & location()
+      { return convert( PART_LOCATION ).location; };
+
+    int32_t latitudeL () { return location().lat (); };
+    float   latitude  () { return location().latF(); };
+    int32_t longitudeL() { return location().lon (); };
+    float   longitude () { return location().lonF(); };
+  #endif
+
+  #ifdef GPS_FIX_LOCATION_DMS
+    const DMS_t & latitudeDMS () { return convert( PART_LOCATION ).latitudeDMS ; };
+    const DMS_t & longitudeDMS() { return convert( PART_LOCATION ).longitudeDMS; };
+  #endif
+
+  #ifdef GPS_FIX_ALTITUDE
+    int32_t altitude_cm() { return convert( PART_ALTITUDE ).altitude_cm(); };
+    float   altitude   () { return convert( PART_ALTITUDE ).altitude   (); };
+    float   altitude_ft() { return convert( PART_ALTITUDE ).altitude_ft(); };
+  #endif
+
+  #ifdef GPS_FIX_SPEED
+    uint32_t speed_mkn     () { return convert( PART_SPEED ).speed_mkn     (); };
+    float    speed         () { return convert( PART_SPEED ).speed         (); };
+    float    speed_kph     () { return convert( PART_SPEED ).speed_kph     (); };
+    uint32_t speed_metersph() { return convert( PART_SPEED ).speed_metersph(); };
+    float    speed_mph     () { return convert( PART_SPEED ).speed_mph     (); };
+  #endif
+
+  #ifdef GPS_FIX_HEADING
+    uint16_t heading_cd() { return convert( PART_HEADING ).heading_cd(); };
+    float    heading   () { return convert( PART_HEADING ).heading   (); };
+  #endif
+
+  #ifdef GPS_FIX_TRUE_HEADING
+    uint16_t true_heading_cd() { return convert( PART_TRUE_HEADING ).true_heading_cd(); };
+    float    true_heading   () { return convert( PART_TRUE_HEADING ).true_heading   (); };
+  #endif
+
+  #ifdef GPS_FIX_SATELLITES
+    uint8_t satellites() { return convert( PART_SATELLITES ).satellites; };
+  #endif
+
+  #ifdef GPS_FIX_HDOP
+    uint16_t hdop() { return convert( PART_HDOP ).hdop; };
+  #endif
+  #ifdef GPS_FIX_VDOP
+    uint16_t vdop() { return convert( PART_VDOP ).vdop; };
+  #endif
+  #ifdef GPS_FIX_PDOP
+    uint16_t pdop() { return convert( PART_PDOP ).pdop; };
+  #endif
+
+  #ifdef GPS_FIX_LAT_ERR
+    uint16_t lat_err_cm() { return convert( PART_LAT_ERR ).lat_err_cm; };
+    float    lat_err   () { return convert( PART_LAT_ERR ).lat_err   (); };
+  #endif
+  #ifdef GPS_FIX_LON_ERR
+    uint16_t lon_err_cm() { return convert( PART_LON_ERR ).lon_err_cm; };
+    float    lon_err   () { return convert( PART_LON_ERR ).lon_err   (); };
+  #endif
+  #ifdef GPS_FIX_ALT_ERR
+    uint16_t alt_err_cm() { return convert( PART_ALT_ERR ).alt_err_cm; };
+    float    alt_err   () { return convert( PART_ALT_ERR ).alt_err   (); };
+  #endif
+
+  #ifdef GPS_FIX_GEOID_HEIGHT
+    int32_t geoidHeight_cm() { return convert( PART_GEOID_HEIGHT ).geoidHeight_cm(); };
+    float   geoidHeight   () { return convert( PART_GEOID_HEIGHT ).geoidHeight   (); };
+  #endif
+
+  #ifdef GPS_FIX_DATUM
+    const char *datum() { return convert( PART_DATUM ).datum; };
+  #endif
+
+private:
+  friend class NMEAGPS;
+
+  //  One sentence, and the offsets of its fields
+  struct slice_t
+    {
+      const uint8_t      *chars;
+      NeoGPS::NMEAframe   frame;
+      NMEAGPS::nmea_msg_t msg NEOGPS_BF(8);
+    };
+
+  NMEAGPS *_parser;
+  gps_fix  _fix;                   // the converted parts
+  uint8_t  _count;                 // sentences in _slice
+  slice_t  _slice[ MAX_SENTENCES ];
+  uint8_t  _next [ PART_COUNT ];   // first _slice not converted for each part
+
+  //  Convert everything and forget the sentences, because the
+  //    characters are about to go away.
+  void release()
+    {
+      materialize();
+      _count = 0;
+      for (uint8_t p=0; p < PART_COUNT; p++)
+        _next[p] = 0;
+    }
+
+}; // lazy_fix
+
+#endif
+
+#endif
@@ -39,6 +39,9 @@ int32_t safeDLon( int32_t p2, int32_t p1 )
 
 } // safeDLon
 
+// The integer versions are in LocationFixed.cpp
+#ifndef NEOGPS_FIXED_POINT_LOCATION
+
 //---------------------------------------------------------------------
 
 float Location_t::DistanceRadians
@@ -47,7 +50,7 @@ float Location_t::DistanceRadians
   int32_t dLonL   = safeDLon( p2.lon(), p1.lon() );
   int32_t dLatL   = p2.lat() - p1.lat();
 
-  if ((abs(dLatL)+abs(dLonL)) < 1000) {
+  if (((uint32_t) abs(dLatL) + (uint32_t) abs(dLonL)) < 1000) {
     //  VERY close together.  Just use equirect approximation with precise integers.
     //    This is not needed for accuracy (that I can measure), but it is
     //    a quicker calculation.
@@ -100,7 +103,7 @@ float Location_t::BearingTo( const Location_t & p1, const Location_t & p2 )
   float   cosLat1 = cos( lat1 );
   float   x, y, bearing;
 
-  if ((abs(dLatL)+abs(dLonL)) < 1000) {
+  if (((uint32_t) abs(dLatL) + (uint32_t) abs(dLonL)) < 1000) {
     //  VERY close together.  Just use equirect approximation with precise integers.
     x       = dLonL * cosLat1;
     y       = dLatL;
@@ -134,4 +137,6 @@ void Location_t::OffsetBy( float distR, float bearingR )
   _lat  = (newLat / (RAD_PER_DEG * LOC_SCALE));
   _lon += (dLon   / (RAD_PER_DEG * LOC_SCALE));
 
-} // OffsetBy
\ No newline at end of file
+} // OffsetBy
+
+#endif
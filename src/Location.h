@@ -113,6 +113,32 @@ public:
     // Offset a location (note distance is in radians, not degrees)
     void OffsetBy( float distR, float bearingR );
 
+    //-----------------------------------
+    // Batch calculations, from one /origin/ to each of /n/ points.
+    //   The results are stored in /out[0..n-1]/, in radians.  The
+    //   points can be an array of Location_t, or separate arrays of
+    //   latitudes and longitudes.  On platforms with AVX2 or NEON,
+    //   several points are calculated at once (see LocationBatch.cpp).
+    //   Otherwise, each point is passed to the single-point version.
+
+    static void DistanceRadians
+      ( const Location_t & origin, const Location_t *points, size_t n, float *out );
+    static void DistanceRadians
+      ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+        size_t n, float *out );
+
+    static void EquirectDistanceRadians
+      ( const Location_t & origin, const Location_t *points, size_t n, float *out );
+    static void EquirectDistanceRadians
+      ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+        size_t n, float *out );
+
+    static void BearingTo
+      ( const Location_t & origin, const Location_t *points, size_t n, float *out );
+    static void BearingTo
+      ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+        size_t n, float *out );
+
 //private: //---------------------------------------
     friend class NMEAGPS; // This does not work?!?
 
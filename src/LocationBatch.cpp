@@ -0,0 +1,544 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Location.h"
+
+#include <string.h>
+
+using namespace NeoGPS;
+
+//---------------------------------------------------------------------
+//  Batch versions of the Location_t calculations.
+//
+//  On x86-64, the AVX2 kernels are compiled even if the rest of the
+//  program is not, and they are selected at run time if the CPU
+//  supports AVX2 and FMA.  On 64-bit ARM, the NEON kernels are always
+//  used.  Everywhere else (e.g., AVR), each point is passed to the
+//  single-point version.
+//
+//  The kernels use the same float formulas as Location.cpp, with
+//  polynomial sin, cos and atan2 (about 2 float ULPs).  Results can
+//  differ from the single-point versions in the last bits, or by more
+//  if NEOGPS_FIXED_POINT_LOCATION is enabled.
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+  #define NEOGPS_BATCH_AVX2
+
+  #include <immintrin.h>
+
+  #ifdef __clang__
+    #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+  #else
+    #pragma GCC push_options
+    #pragma GCC target("avx2,fma")
+  #endif
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+  #define NEOGPS_BATCH_NEON
+
+  #include <arm_neon.h>
+
+#endif
+
+#if defined(NEOGPS_BATCH_AVX2) | defined(NEOGPS_BATCH_NEON)
+
+  #define NEOGPS_BATCH_SIMD
+
+namespace {
+
+//---------------------------------------------------------------------
+//  The operations used by the kernels, for each instruction set.
+//    F is a vector of floats, I is a vector of int32_t, and M is the
+//    result of a comparison (all ones or all zeroes in each lane).
+
+#ifdef NEOGPS_BATCH_AVX2
+
+  struct Vec
+  {
+    enum { LANES = 8 };
+    typedef __m256  F;
+    typedef __m256i I;
+    typedef __m256  M;
+
+    static F set ( float f )             { return _mm256_set1_ps( f ); }
+    static I seti( int32_t i )           { return _mm256_set1_epi32( i ); }
+    static I load( const int32_t *p )
+      { return _mm256_loadu_si256( (const __m256i *) p ); }
+    static void store( float *p, F f )   { _mm256_storeu_ps( p, f ); }
+
+    static F add ( F a, F b )            { return _mm256_add_ps( a, b ); }
+    static F sub ( F a, F b )            { return _mm256_sub_ps( a, b ); }
+    static F mul ( F a, F b )            { return _mm256_mul_ps( a, b ); }
+    static F div ( F a, F b )            { return _mm256_div_ps( a, b ); }
+    static F fma ( F a, F b, F c )       { return _mm256_fmadd_ps( a, b, c ); } // a*b+c
+    static F sqrt( F a )                 { return _mm256_sqrt_ps( a ); }
+    static F abs ( F a )
+      { return _mm256_andnot_ps( _mm256_set1_ps( -0.0f ), a ); }
+    static F min ( F a, F b )            { return _mm256_min_ps( a, b ); }
+    static F max ( F a, F b )            { return _mm256_max_ps( a, b ); }
+    static F round( F a )
+      { return _mm256_round_ps( a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC ); }
+    static M lt  ( F a, F b )            { return _mm256_cmp_ps( a, b, _CMP_LT_OQ ); }
+    static F select( M m, F a, F b )     { return _mm256_blendv_ps( b, a, m ); }
+
+    static F toF ( I i )                 { return _mm256_cvtepi32_ps( i ); }
+    static I toI ( F f )                 { return _mm256_cvtps_epi32( f ); }
+
+    static I addi( I a, I b )            { return _mm256_add_epi32( a, b ); }
+    static I subi( I a, I b )            { return _mm256_sub_epi32( a, b ); }
+    static I absi( I a )                 { return _mm256_abs_epi32( a ); }
+    static I half( I a ) // a/2, truncated like C
+      {
+        return _mm256_srai_epi32( _mm256_sub_epi32( a, _mm256_srai_epi32( a, 31 ) ), 1 );
+      }
+    static M gti ( I a, I b )
+      { return _mm256_castsi256_ps( _mm256_cmpgt_epi32( a, b ) ); }
+    static M bit ( I a, int32_t b ) // (a & b) != 0
+      {
+        __m256i bb = _mm256_set1_epi32( b );
+        return _mm256_castsi256_ps
+                 ( _mm256_cmpeq_epi32( _mm256_and_si256( a, bb ), bb ) );
+      }
+    static I selecti( M m, I a, I b )
+      { return _mm256_blendv_epi8( b, a, _mm256_castps_si256( m ) ); }
+    static M andm( M a, M b )            { return _mm256_and_ps( a, b ); }
+  };
+
+#else // NEON
+
+  struct Vec
+  {
+    enum { LANES = 4 };
+    typedef float32x4_t F;
+    typedef int32x4_t   I;
+    typedef uint32x4_t  M;
+
+    static F set ( float f )             { return vdupq_n_f32( f ); }
+    static I seti( int32_t i )           { return vdupq_n_s32( i ); }
+    static I load( const int32_t *p )    { return vld1q_s32( p ); }
+    static void store( float *p, F f )   { vst1q_f32( p, f ); }
+
+    static F add ( F a, F b )            { return vaddq_f32( a, b ); }
+    static F sub ( F a, F b )            { return vsubq_f32( a, b ); }
+    static F mul ( F a, F b )            { return vmulq_f32( a, b ); }
+    static F div ( F a, F b )            { return vdivq_f32( a, b ); }
+    static F fma ( F a, F b, F c )       { return vfmaq_f32( c, a, b ); } // a*b+c
+    static F sqrt( F a )                 { return vsqrtq_f32( a ); }
+    static F abs ( F a )                 { return vabsq_f32( a ); }
+    static F min ( F a, F b )            { return vminq_f32( a, b ); }
+    static F max ( F a, F b )            { return vmaxq_f32( a, b ); }
+    static F round( F a )                { return vrndnq_f32( a ); }
+    static M lt  ( F a, F b )            { return vcltq_f32( a, b ); }
+    static F select( M m, F a, F b )     { return vbslq_f32( m, a, b ); }
+
+    static F toF ( I i )                 { return vcvtq_f32_s32( i ); }
+    static I toI ( F f )                 { return vcvtnq_s32_f32( f ); }
+
+    static I addi( I a, I b )            { return vaddq_s32( a, b ); }
+    static I subi( I a, I b )            { return vsubq_s32( a, b ); }
+    static I absi( I a )                 { return vabsq_s32( a ); }
+    static I half( I a ) // a/2, truncated like C
+      { return vshrq_n_s32( vsubq_s32( a, vshrq_n_s32( a, 31 ) ), 1 ); }
+    static M gti ( I a, I b )            { return vcgtq_s32( a, b ); }
+    static M bit ( I a, int32_t b )      { return vtstq_s32( a, vdupq_n_s32( b ) ); }
+    static I selecti( M m, I a, I b )    { return vbslq_s32( m, a, b ); }
+    static M andm( M a, M b )            { return vandq_u32( a, b ); }
+  };
+
+#endif
+
+typedef Vec::F F;
+typedef Vec::I I;
+typedef Vec::M M;
+
+static const float RAD_PER_DEG = Location_t::RAD_PER_DEG;
+static const float LOC_SCALE   = Location_t::LOC_SCALE;
+
+//---------------------------------------------------------------------
+//  Sine and cosine, from the Cephes sinf and cosf.  The argument is
+//    reduced to -PI/4..PI/4 by subtracting a multiple of PI/2 in three
+//    parts.  Accurate for |x| up to a few hundred radians.
+
+static void sinCos( F x, F & s, F & c )
+{
+  F q = Vec::round( Vec::mul( x, Vec::set( 2.0 / PI ) ) );
+  F r = Vec::fma( q, Vec::set( -1.5703125f ), x );
+  r   = Vec::fma( q, Vec::set( -4.837512969970703125e-4f ), r );
+  r   = Vec::fma( q, Vec::set( -7.54978995489188216e-8f ), r );
+
+  F z  = Vec::mul( r, r );
+
+  F sp = Vec::fma( Vec::set( -1.9515295891e-4f ), z, Vec::set( 8.3321608736e-3f ) );
+  sp   = Vec::fma( sp, z, Vec::set( -1.6666654611e-1f ) );
+  sp   = Vec::fma( Vec::mul( sp, z ), r, r );
+
+  F cp = Vec::fma( Vec::set( 2.443315711809948e-5f ), z, Vec::set( -1.388731625493765e-3f ) );
+  cp   = Vec::fma( cp, z, Vec::set( 4.166664568298827e-2f ) );
+  cp   = Vec::fma( Vec::mul( cp, z ), z, Vec::fma( Vec::set( -0.5f ), z, Vec::set( 1.0f ) ) );
+
+  //  Select the quadrant
+  I qi   = Vec::toI( q );
+  M odd  = Vec::bit( qi, 1 );
+  F zero = Vec::set( 0.0f );
+
+  s = Vec::select( odd, cp, sp );
+  c = Vec::select( odd, sp, cp );
+  s = Vec::select( Vec::bit( qi, 2 ), Vec::sub( zero, s ), s );
+  c = Vec::select( Vec::bit( Vec::addi( qi, Vec::seti( 1 ) ), 2 ), Vec::sub( zero, c ), c );
+
+} // sinCos
+
+//---------------------------------------------------------------------
+//  atan2, from the Cephes atanf.  atan2(0,0) is 0, like the math
+//    library.
+
+static F atan2( F y, F x )
+{
+  F zero = Vec::set( 0.0f );
+  F ax   = Vec::abs( x );
+  F ay   = Vec::abs( y );
+  F mx   = Vec::max( ax, ay );
+  F t    = Vec::div( Vec::min( ax, ay ), mx );
+  t      = Vec::select( Vec::lt( zero, mx ), t, zero ); // 0/0
+
+  //  Reduce to 0..tan(PI/8)
+  M big  = Vec::lt( Vec::set( 0.4142135623730950f ), t );
+  F one  = Vec::set( 1.0f );
+  t      = Vec::select( big, Vec::div( Vec::sub( t, one ), Vec::add( t, one ) ), t );
+
+  F z    = Vec::mul( t, t );
+  F p    = Vec::fma( Vec::set( 8.05374449538e-2f ), z, Vec::set( -1.38776856032e-1f ) );
+  p      = Vec::fma( p, z, Vec::set( 1.99777106478e-1f ) );
+  p      = Vec::fma( p, z, Vec::set( -3.33329491539e-1f ) );
+  p      = Vec::fma( Vec::mul( p, z ), t, t );
+  p      = Vec::add( p, Vec::select( big, Vec::set( PI/4 ), zero ) );
+
+  //  Unfold the octant
+  p = Vec::select( Vec::lt( ax, ay ), Vec::sub( Vec::set( PI/2 ), p ), p );
+  p = Vec::select( Vec::lt( x, zero ), Vec::sub( Vec::set( PI ), p ), p );
+  p = Vec::select( Vec::lt( y, zero ), Vec::sub( zero, p ), p );
+
+  return p;
+
+} // atan2
+
+//---------------------------------------------------------------------
+//  Same as safeDLon in Location.cpp.  The int32_t lanes wrap around,
+//    so adding 3600000000 is the same as adding 3600000000 - 2^32.
+
+static I safeDLon( I p2, I p1 )
+{
+  const int32_t FULL_CIRCLE = (int32_t) (3600000000LL - 4294967296LL);
+
+  I halfDLon = Vec::subi( Vec::half( p2 ), Vec::half( p1 ) );
+  I dLon     = Vec::subi( p2, p1 );
+
+  dLon = Vec::selecti( Vec::gti( Vec::seti( -1800000000L/2 ), halfDLon ),
+                       Vec::addi( dLon, Vec::seti( FULL_CIRCLE ) ), dLon );
+  dLon = Vec::selecti( Vec::gti( halfDLon, Vec::seti( 1800000000L/2 ) ),
+                       Vec::subi( dLon, Vec::seti( FULL_CIRCLE ) ), dLon );
+  return dLon;
+
+} // safeDLon
+
+//---------------------------------------------------------------------
+//  Each kernel calculates LANES points.
+
+struct distance_t
+{
+  F cosLat1;
+
+  distance_t( const Location_t & origin )
+    : cosLat1( Vec::set( cos( origin.latF() * RAD_PER_DEG ) ) )
+      {}
+
+  F operator ()( I dLatL, I dLonL, I lat2L ) const
+    {
+      // Haversine
+      F s, c;
+      F half      = Vec::set( 0.5f );
+      F dLat      = Vec::mul( Vec::mul( Vec::toF( dLatL ), Vec::set( RAD_PER_DEG ) ),
+                              Vec::set( LOC_SCALE ) );
+      sinCos( Vec::mul( dLat, half ), s, c );
+      F haverDLat = Vec::mul( s, s );
+
+      F dLon      = Vec::mul( Vec::mul( Vec::toF( dLonL ), Vec::set( RAD_PER_DEG ) ),
+                              Vec::set( LOC_SCALE ) );
+      sinCos( Vec::mul( dLon, half ), s, c );
+      F haverDLon = Vec::mul( s, s );
+
+      F lat2      = Vec::mul( Vec::mul( Vec::toF( lat2L ), Vec::set( LOC_SCALE ) ),
+                              Vec::set( RAD_PER_DEG ) );
+      sinCos( lat2, s, c );
+
+      F one = Vec::set( 1.0f );
+      F a   = Vec::fma( Vec::mul( cosLat1, c ), haverDLon, haverDLat );
+      a     = Vec::min( Vec::max( a, Vec::set( 0.0f ) ), one );
+
+      F dist = atan2( Vec::sqrt( a ), Vec::sqrt( Vec::sub( one, a ) ) );
+      return Vec::add( dist, dist );
+    }
+};
+
+struct equirect_t
+{
+  F lat1;
+
+  equirect_t( const Location_t & origin )
+    : lat1( Vec::set( origin.lat() * RAD_PER_DEG * LOC_SCALE ) )
+      {}
+
+  F operator ()( I dLatL, I dLonL, I ) const
+    {
+      F dLat = Vec::mul( Vec::mul( Vec::toF( dLatL ), Vec::set( RAD_PER_DEG ) ),
+                         Vec::set( LOC_SCALE ) );
+      F dLon = Vec::mul( Vec::mul( Vec::toF( dLonL ), Vec::set( RAD_PER_DEG ) ),
+                         Vec::set( LOC_SCALE ) );
+      F s, c;
+      sinCos( Vec::fma( dLat, Vec::set( 0.5f ), lat1 ), s, c );
+
+      F x = Vec::mul( dLon, c );
+      return Vec::sqrt( Vec::fma( x, x, Vec::mul( dLat, dLat ) ) );
+    }
+};
+
+struct bearing_t
+{
+  F sinLat1, cosLat1;
+
+  bearing_t( const Location_t & origin )
+    {
+      float lat1 = origin.lat() * RAD_PER_DEG * LOC_SCALE;
+      sinLat1 = Vec::set( sin( lat1 ) );
+      cosLat1 = Vec::set( cos( lat1 ) );
+    }
+
+  F operator ()( I dLatL, I dLonL, I lat2L ) const
+    {
+      F dLon = Vec::mul( Vec::mul( Vec::toF( dLonL ), Vec::set( RAD_PER_DEG ) ),
+                         Vec::set( LOC_SCALE ) );
+      F lat2 = Vec::mul( Vec::mul( Vec::toF( lat2L ), Vec::set( RAD_PER_DEG ) ),
+                         Vec::set( LOC_SCALE ) );
+      F sinDLon, cosDLon, sinLat2, cosLat2;
+      sinCos( dLon, sinDLon, cosDLon );
+      sinCos( lat2, sinLat2, cosLat2 );
+
+      F y = Vec::mul( sinDLon, cosLat2 );
+      F x = Vec::sub( Vec::mul( cosLat1, sinLat2 ),
+                      Vec::mul( Vec::mul( sinLat1, cosLat2 ), cosDLon ) );
+      F bearing = atan2( y, x );
+
+      //  VERY close together.  Use the equirect approximation with
+      //    precise integers, like BearingTo.
+      I sum   = Vec::addi( Vec::absi( dLatL ), Vec::absi( dLonL ) ); // unsigned
+      M close = Vec::andm( Vec::gti( sum, Vec::seti( -1 ) ),
+                           Vec::gti( Vec::seti( 1000 ), sum ) );
+      F closeBearing =
+        Vec::sub( Vec::set( PI/2.0 ),
+                  atan2( Vec::toF( dLatL ), Vec::mul( Vec::toF( dLonL ), cosLat1 ) ) );
+      bearing = Vec::select( close, closeBearing, bearing );
+
+      F zero  = Vec::set( 0.0f );
+      return Vec::select( Vec::lt( bearing, zero ),
+                          Vec::add( bearing, Vec::set( TWO_PI ) ), bearing );
+    }
+};
+
+//---------------------------------------------------------------------
+//  Apply a kernel to all the points.  The last few points are copied
+//    to a full vector, padded with the origin.
+
+template <class Kernel>
+static void batch
+  ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+    size_t n, float *out )
+{
+  Kernel kernel( origin );
+  I      lat1 = Vec::seti( origin.lat() );
+  I      lon1 = Vec::seti( origin.lon() );
+
+  size_t i = 0;
+  for (; i + Vec::LANES <= n; i += Vec::LANES) {
+    I lat2 = Vec::load( &lats[i] );
+    I lon2 = Vec::load( &lons[i] );
+    Vec::store( &out[i], kernel( Vec::subi( lat2, lat1 ), safeDLon( lon2, lon1 ), lat2 ) );
+  }
+
+  if (i < n) {
+    int32_t lat2[ Vec::LANES ], lon2[ Vec::LANES ];
+    float   result[ Vec::LANES ];
+    size_t  rest = n - i;
+
+    for (size_t j=0; j < Vec::LANES; j++) {
+      lat2[j] = (j < rest) ? lats[i+j] : origin.lat();
+      lon2[j] = (j < rest) ? lons[i+j] : origin.lon();
+    }
+
+    I lat2v = Vec::load( lat2 );
+    Vec::store( result,
+                kernel( Vec::subi( lat2v, lat1 ), safeDLon( Vec::load( lon2 ), lon1 ), lat2v ) );
+    memcpy( &out[i], result, rest * sizeof(float) );
+  }
+
+} // batch
+
+} // namespace
+
+#endif
+
+#ifdef NEOGPS_BATCH_AVX2
+  #ifdef __clang__
+    #pragma clang attribute pop
+  #else
+    #pragma GCC pop_options
+  #endif
+#endif
+
+//---------------------------------------------------------------------
+//  Can the kernels be used on this CPU?
+
+#if defined(NEOGPS_BATCH_AVX2)
+
+  static bool supported()
+  {
+    static int8_t avx2 = -1;
+    if (avx2 < 0)
+      avx2 = __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+    return avx2;
+  }
+
+#elif defined(NEOGPS_BATCH_NEON)
+
+  static bool supported() { return true; }
+
+#endif
+
+//---------------------------------------------------------------------
+//  Location_t arrays are copied to separate latitude and longitude
+//    arrays, one block at a time.  Without a SIMD kernel, each point
+//    is passed to the single-point version.
+
+typedef void (*batchFunction_t)
+  ( const Location_t &, const int32_t *, const int32_t *, size_t, float * );
+typedef float (*pointFunction_t)( const Location_t &, const Location_t & );
+
+static void unzip
+  ( batchFunction_t batchF, pointFunction_t pointF,
+    const Location_t & origin, const Location_t *points, size_t n, float *out )
+{
+  #ifdef NEOGPS_BATCH_SIMD
+    if (supported()) {
+      const size_t BLOCK = 32;
+      int32_t lats[ BLOCK ], lons[ BLOCK ];
+
+      while (n > 0) {
+        size_t count = (n < BLOCK) ? n : BLOCK;
+
+        for (size_t i=0; i < count; i++) {
+          lats[i] = points[i].lat();
+          lons[i] = points[i].lon();
+        }
+        batchF( origin, lats, lons, count, out );
+
+        points += count;
+        out    += count;
+        n      -= count;
+      }
+      return;
+    }
+  #else
+    (void) batchF;
+  #endif
+
+  for (size_t i=0; i < n; i++)
+    out[i] = pointF( origin, points[i] );
+
+} // unzip
+
+//---------------------------------------------------------------------
+
+void Location_t::DistanceRadians
+  ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+    size_t n, float *out )
+{
+  #ifdef NEOGPS_BATCH_SIMD
+    if (supported()) {
+      batch<distance_t>( origin, lats, lons, n, out );
+      return;
+    }
+  #endif
+
+  for (size_t i=0; i < n; i++)
+    out[i] = DistanceRadians( origin, Location_t( lats[i], lons[i] ) );
+
+} // DistanceRadians
+
+void Location_t::DistanceRadians
+  ( const Location_t & origin, const Location_t *points, size_t n, float *out )
+{
+  unzip( &DistanceRadians, &DistanceRadians, origin, points, n, out );
+}
+
+//---------------------------------------------------------------------
+
+void Location_t::EquirectDistanceRadians
+  ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+    size_t n, float *out )
+{
+  #ifdef NEOGPS_BATCH_SIMD
+    if (supported()) {
+      batch<equirect_t>( origin, lats, lons, n, out );
+      return;
+    }
+  #endif
+
+  for (size_t i=0; i < n; i++)
+    out[i] = EquirectDistanceRadians( origin, Location_t( lats[i], lons[i] ) );
+
+} // EquirectDistanceRadians
+
+void Location_t::EquirectDistanceRadians
+  ( const Location_t & origin, const Location_t *points, size_t n, float *out )
+{
+  unzip( &EquirectDistanceRadians, &EquirectDistanceRadians, origin, points, n, out );
+}
+
+//---------------------------------------------------------------------
+
+void Location_t::BearingTo
+  ( const Location_t & origin, const int32_t *lats, const int32_t *lons,
+    size_t n, float *out )
+{
+  #ifdef NEOGPS_BATCH_SIMD
+    if (supported()) {
+      batch<bearing_t>( origin, lats, lons, n, out );
+      return;
+    }
+  #endif
+
+  for (size_t i=0; i < n; i++)
+    out[i] = BearingTo( origin, Location_t( lats[i], lons[i] ) );
+
+} // BearingTo
+
+void Location_t::BearingTo
+  ( const Location_t & origin, const Location_t *points, size_t n, float *out )
+{
+  unzip( &BearingTo, &BearingTo, origin, points, n, out );
+}
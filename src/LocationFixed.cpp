@@ -0,0 +1,356 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Location.h"
+
+// Disable the entire file if the float versions are used (Location.cpp).
+#ifdef NEOGPS_FIXED_POINT_LOCATION
+
+#include "CosaCompat.h"
+
+#include <string.h>
+
+using namespace NeoGPS;
+
+//---------------------------------------------------------------------
+//  Integer versions of the Location_t calculations.
+//
+//  Angles are binary angles: 2^64 is one full circle, so adding and
+//  subtracting angles wraps around just like longitudes.  Sines,
+//  cosines and other values are fixed-point numbers with 61 fraction
+//  bits (Q61, 1.0 is 2^61), which leaves room for the CORDIC gain.
+//
+//  Because the integer coordinates are converted without rounding to
+//  a float, and all the intermediate values have 61 bits, the usual
+//  formulas are accurate for any distance, from millimeters to the
+//  other side of the earth.  Only the float results are rounded.
+//  See Location.md for the measured errors.
+
+typedef uint64_t angle_t; // 2^64 per circle
+
+static const int64_t ONE = 1LL << 61;
+
+//---------------------------------------------------------------------
+//  (a * b) >> shift, rounded, for 0 < shift <= 64.  The 128-bit
+//    product is used when the compiler has it.
+
+static int64_t mulShift( int64_t a, uint64_t b, uint8_t shift )
+{
+  bool     negative = (a < 0);
+  uint64_t ua       = negative ? -(uint64_t) a : (uint64_t) a;
+  uint64_t r;
+
+  #ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128) ua * b;
+    r = (uint64_t) ((p + ((unsigned __int128) 1 << (shift-1))) >> shift);
+  #else
+    //  Four 32x32 partial products
+    uint64_t aH = ua >> 32, aL = (uint32_t) ua;
+    uint64_t bH = b  >> 32, bL = (uint32_t) b;
+    uint64_t ll = aL * bL;
+    uint64_t lh = aL * bH;
+    uint64_t hl = aH * bL;
+    uint64_t hh = aH * bH;
+
+    uint64_t mid = (ll >> 32) + (uint32_t) lh + (uint32_t) hl;
+    uint64_t hi  = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    uint64_t lo  = (mid << 32) | (uint32_t) ll;
+
+    //  Round
+    uint64_t half = 1ULL << (shift-1);
+    lo += half;
+    if (lo < half)
+      hi++;
+
+    r = (shift == 64) ? hi : ((hi << (64-shift)) | (lo >> shift));
+  #endif
+
+  return (int64_t) (negative ? -r : r);
+
+} // mulShift
+
+static inline int64_t mulQ61( int64_t a, int64_t b )
+{
+  return (b < 0) ? -mulShift( a, -(uint64_t) b, 61 )
+                 :  mulShift( a,  (uint64_t) b, 61 );
+}
+
+//---------------------------------------------------------------------
+//  There is no pgm_read_qword
+
+static uint64_t read64_P( const void *p )
+{
+  uint64_t v;
+  memcpy_P( &v, p, sizeof(v) );
+  return v;
+}
+
+//---------------------------------------------------------------------
+//  Conversions
+
+static const uint64_t ANGLE_PER_RADIAN = 0x28BE60DB9391054AULL; // 2^64 / 2PI
+static const uint64_t PI_4             = 1811004864519280711ULL; // Q61
+
+//  2^64 / 3600000000 = 5124095576.0304310044...
+static angle_t angleFromLoc( int32_t degE7 )
+{
+  return (uint64_t) (int64_t) degE7 * 5124095576ULL +
+         (uint64_t) (((int64_t) degE7 * 130700159LL) >> 32);
+}
+
+static int32_t locFromAngle( angle_t a )
+{
+  return (int32_t) mulShift( (int64_t) a, 3600000000ULL, 64 );
+}
+
+static float radiansFromAngle( angle_t a ) // 0..2PI
+{
+  return ((float) a) * (float) (PI / 9223372036854775808.0);
+}
+
+static angle_t angleFromRadians( float r )
+{
+  //  Multiply the 24-bit mantissa by the 64-bit radians-to-angle
+  //    constant, so the float is converted exactly.  Any multiple of
+  //    2PI wraps around.
+  int     e;
+  int32_t m     = (int32_t) (frexp( r, &e ) * 16777216.0); // 2^24
+  int16_t shift = 24 - e;
+
+  if (shift < 1)
+    return 0; // no fraction bits left (r is more than 8 million)
+  if (shift > 64) {
+    if (shift > 64+24)
+      return 0;
+    m    >>= (shift - 64);
+    shift  = 64;
+  }
+
+  return (angle_t) mulShift( m, ANGLE_PER_RADIAN, shift );
+}
+
+//---------------------------------------------------------------------
+//  Sine and cosine of an angle, Q61.
+//
+//  The angle is reduced to 0..PI/4 (one octant), where the Taylor
+//  series converge to less than 1 LSB.
+
+static const int64_t SIN_COEFF[] __PROGMEM = // (-1)^k / (2k+1)!
+  { -384307168202282325LL, 19215358410114116LL, -457508533574146LL,
+    6354285188530LL, -57766228987LL, 370296340LL, -1763316LL, 6483LL };
+static const int64_t COS_COEFF[] __PROGMEM = // (-1)^k / (2k)!
+  { -1152921504606846976LL, 96076792050570581LL, -3202559735019019LL,
+    57188566696768LL, -635428518853LL, 4813852416LL, -26449739LL,
+    110207LL, -360LL };
+
+static void sinCos( angle_t a, int64_t & s, int64_t & c )
+{
+  uint8_t  octant = (uint8_t) (a >> 61);
+  uint64_t r      = a & (ONE - 1);
+  if (octant & 1)
+    r = ONE - r; // distance from the next octant
+
+  int64_t x  = mulShift( (int64_t) r, PI_4, 61 );
+  int64_t x2 = mulQ61( x, x );
+
+  int8_t  k  = sizeof(SIN_COEFF)/sizeof(SIN_COEFF[0]) - 1;
+  int64_t p  = read64_P( &SIN_COEFF[k] );
+  while (--k >= 0)
+    p = read64_P( &SIN_COEFF[k] ) + mulQ61( x2, p );
+  int64_t s0 = x + mulQ61( mulQ61( x, x2 ), p );
+
+  k = sizeof(COS_COEFF)/sizeof(COS_COEFF[0]) - 1;
+  p = read64_P( &COS_COEFF[k] );
+  while (--k >= 0)
+    p = read64_P( &COS_COEFF[k] ) + mulQ61( x2, p );
+  int64_t c0 = ONE + mulQ61( x2, p );
+
+  //  Unfold the octant
+  if ((octant + 1) & 2) {
+    s = c0;
+    c = s0;
+  } else {
+    s = s0;
+    c = c0;
+  }
+  if (octant & 4)
+    s = -s;
+  if ((octant + 2) & 4)
+    c = -c;
+
+} // sinCos
+
+//---------------------------------------------------------------------
+//  CORDIC vectoring: rotate (x,y) onto the x axis, with shifts and adds.
+//    Returns the angle of (x,y).  x becomes the length of (x,y), times
+//    the CORDIC gain (about 1.647).  The inputs must not exceed 1.0.
+
+static const uint8_t CORDIC_STEPS = 48; // < 5e-15 radians
+
+static const uint64_t ATAN_TABLE[] __PROGMEM = // atan(2^-i), i < 22
+  {
+    0x2000000000000000ULL, 0x12E4051D9DF30866ULL, 0x09FB385B5EE39E8EULL,
+    0x051111D41DDD9A1BULL, 0x028B0D430E589AEDULL, 0x0145D7E159046278ULL,
+    0x00A2F61E5C28262AULL, 0x00517C5511D442AFULL, 0x0028BE5346D0C337ULL,
+    0x00145F2EBB30AB38ULL, 0x000A2F980091BA7BULL, 0x000517CC14A80CB7ULL,
+    0x00028BE60CDFEC62ULL, 0x000145F306C172F2ULL, 0x0000A2F9836AE911ULL,
+    0x0000517CC1B6BA7CULL, 0x000028BE60DB85FCULL, 0x0000145F306DC816ULL,
+    0x00000A2F9836E4AEULL, 0x00000517CC1B726BULL, 0x0000028BE60DB938ULL,
+    0x00000145F306DC9CULL
+  };
+static const uint8_t  ATAN_TABLE_SIZE = sizeof(ATAN_TABLE)/sizeof(ATAN_TABLE[0]);
+
+static angle_t vectoring( int64_t & x, int64_t y )
+{
+  angle_t angle = 0;
+
+  if (x < 0) {
+    // Rotate by PI into the right half-plane
+    x     = -x;
+    y     = -y;
+    angle = 1ULL << 63;
+  }
+
+  for (uint8_t i=0; i < CORDIC_STEPS; i++) {
+    int64_t  dx = y >> i;
+    int64_t  dy = x >> i;
+    uint64_t da = (i < ATAN_TABLE_SIZE) ? read64_P( &ATAN_TABLE[i] ) : (ANGLE_PER_RADIAN >> i);
+
+    if (y > 0) {
+      x     += dx;
+      y     -= dy;
+      angle += da;
+    } else {
+      x     -= dx;
+      y     += dy;
+      angle -= da;
+    }
+  }
+
+  return angle;
+
+} // vectoring
+
+static const int64_t CORDIC_GAIN = 3797170629039397408LL; // Q61
+
+//---------------------------------------------------------------------
+//  The central angle and the initial bearing are computed together.
+//    y and x are the east and north components of the direction to p2,
+//    and their length is the sine of the central angle.
+
+static void greatCircle
+  ( const Location_t & p1, const Location_t & p2,
+    int64_t & y, int64_t & x, int64_t & cosDist )
+{
+  int64_t s1, c1, s2, c2, sdLon, cdLon;
+
+  sinCos( angleFromLoc( p1.lat() ), s1, c1 );
+  sinCos( angleFromLoc( p2.lat() ), s2, c2 );
+  sinCos( angleFromLoc( p2.lon() ) - angleFromLoc( p1.lon() ), sdLon, cdLon );
+
+  int64_t c2cdLon = mulQ61( c2, cdLon );
+
+  y       = mulQ61( c2, sdLon );
+  x       = mulQ61( c1, s2 ) - mulQ61( s1, c2cdLon );
+  cosDist = mulQ61( s1, s2 ) + mulQ61( c1, c2cdLon );
+
+} // greatCircle
+
+//---------------------------------------------------------------------
+
+float Location_t::DistanceRadians
+  ( const Location_t & p1, const Location_t & p2 )
+{
+  int64_t y, x, cosDist;
+  greatCircle( p1, p2, y, x, cosDist );
+
+  //  The sine of the distance is the length of (x,y).  Both legs of
+  //    the final atan2 are multiplied by the CORDIC gain.
+  vectoring( x, y );
+  int64_t c = mulQ61( cosDist, CORDIC_GAIN );
+
+  return radiansFromAngle( vectoring( c, x ) );
+
+} // DistanceRadians
+
+//---------------------------------------------------------------------
+
+float Location_t::EquirectDistanceRadians
+  ( const Location_t & p1, const Location_t & p2 )
+{
+  // Equirectangular calculation from http://www.movable-type.co.uk/scripts/latlong.html
+
+  angle_t lat1 = angleFromLoc( p1.lat() );
+  int64_t dLat = angleFromLoc( p2.lat() ) - lat1;
+  int64_t dLon = angleFromLoc( p2.lon() ) - angleFromLoc( p1.lon() );
+
+  int64_t s, c;
+  sinCos( lat1 + dLat/2, s, c );
+
+  //  Angles to radians/4 (Q61), so the length times the CORDIC gain
+  //    does not overflow.
+  int64_t y = mulShift( dLat, PI_4, 63 );
+  int64_t x = mulQ61( mulShift( dLon, PI_4, 63 ), c );
+
+  vectoring( x, y );
+  x = mulQ61( x, 1400229935014726477LL ); // / CORDIC_GAIN
+
+  return ((float) x) * (float) (4.0 / 2305843009213693952.0); // 4 / 2^61
+
+} // EquirectDistanceRadians
+
+//---------------------------------------------------------------------
+
+float Location_t::BearingTo( const Location_t & p1, const Location_t & p2 )
+{
+  int64_t y, x, cosDist;
+  greatCircle( p1, p2, y, x, cosDist );
+
+  if ((x == 0) && (y == 0))
+    return 0.0; // same location
+
+  //  0..2PI, CW from North
+  return radiansFromAngle( vectoring( x, y ) );
+
+} // BearingTo
+
+//---------------------------------------------------------------------
+
+void Location_t::OffsetBy( float distR, float bearingR )
+{
+  int64_t sLat, cLat, sDist, cDist, sBrg, cBrg;
+  sinCos( angleFromLoc( lat() )      , sLat , cLat  );
+  sinCos( angleFromRadians( distR )   , sDist, cDist );
+  sinCos( angleFromRadians( bearingR ), sBrg , cBrg  );
+
+  //  The new location as a unit vector, in a frame where the old
+  //    location is at longitude 0.
+  int64_t sDistCBrg = mulQ61( sDist, cBrg );
+  int64_t x = mulQ61( cDist, cLat ) - mulQ61( sDistCBrg, sLat );
+  int64_t y = mulQ61( sDist, sBrg );
+  int64_t z = mulQ61( cDist, sLat ) + mulQ61( sDistCBrg, cLat );
+
+  angle_t dLon = vectoring( x, y );     // x is now cos(newLat) * gain
+  z = mulQ61( z, CORDIC_GAIN );
+  angle_t newLat = vectoring( x, z );
+
+  _lat = locFromAngle( newLat );
+  _lon = locFromAngle( angleFromLoc( lon() ) + dLon ); // wraps at 180
+
+} // OffsetBy
+
+#endif
@@ -16,8 +16,10 @@
 //  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "NMEAGPS.h"
+#include "NMEAframe.h"
 
 #include <Stream.h>
+#include <string.h>
 
 // Check configurations
 
@@ -77,6 +79,31 @@ NMEAGPS::NMEAGPS()
 
   data_init();
 
+  // Instances are not always static (i.e., zeroed), so start with an
+  //   empty fix buffer.
+  _overrun          = false;
+  _intervalComplete = false;
+  #if (NMEAGPS_FIX_MAX == 0)
+    _fixesAvailable = false;
+  #else
+    _fixHead        = 0;
+    _fixTail        = 0;
+    _peekTail       = 0;
+    _fixStarted     = false;
+  #endif
+  #ifdef NMEAGPS_EXTENDED_STATS
+    _intervalTimed  = false;
+  #endif
+  #ifdef NMEAGPS_TRACE_LATENCY
+    _traceFirstChar = 0;
+    trace.init();
+  #endif
+  #ifdef NMEAGPS_RUNTIME_PROFILE
+    profile_t everything;
+    everything.init();
+    profile( everything );
+  #endif
+
   reset();
 }
 
@@ -85,6 +112,10 @@ NMEAGPS::NMEAGPS()
 
 void NMEAGPS::sentenceBegin()
 {
+  #ifdef NMEAGPS_TRACE_LATENCY
+    traceBegin();
+  #endif
+
   if (intervalComplete()) {
     // GPS quiet time is over, this is the start of a new interval.
 
@@ -93,17 +124,30 @@ void NMEAGPS::sentenceBegin()
       _IntervalStart = micros();
     #endif
 
+    #ifdef NMEAGPS_EXTENDED_STATS
+      statsIntervalBegin();
+    #endif
+
     intervalComplete( false );
 
-    #ifdef NMEAGPS_PARSE_SATELLITES
+    #if defined(NMEAGPS_PARSE_SATELLITES) & !defined(NMEAGPS_SATELLITE_TABLE)
       sat_count = 0;
     #endif
   }
 
+  #ifdef NMEAGPS_SHADOW_FIX
+    //  The previous sentence was cut short.  Discard its fields.
+    if ((rxState == NMEA_RECEIVING_DATA) ||
+        (rxState == NMEA_RECEIVING_CRC ) ||
+        (rxState == NMEA_SKIPPING_DATA))
+      rejectFix();
+  #endif
+
   crc          = 0;
   nmeaMessage  = NMEA_UNKNOWN;
   rxState      = NMEA_RECEIVING_HEADER;
   chrCount     = 0;
+  cmdKey       = 0;
   comma_needed( false );
 
   #ifdef NMEAGPS_PARSE_PROPRIETARY
@@ -138,6 +182,16 @@ void NMEAGPS::sentenceOk()
   #ifdef NMEAGPS_STATS
     statistics.ok++;
   #endif
+  #ifdef NMEAGPS_EXTENDED_STATS
+    statistics.message( nmeaMessage ).ok++;
+  #endif
+
+  //  A GSA or GSV that was only checksummed (not selected by the
+  //    configuration or profile) left nothing in the union.
+  #ifdef NMEAGPS_SATELLITE_TABLE
+    if (_parsed)
+      satellitesOk();
+  #endif
 
   //  This implements coherency.
   intervalComplete( intervalCompleted() );
@@ -155,8 +209,8 @@ void NMEAGPS::sentenceOk()
 
 void NMEAGPS::sentenceInvalid()
 {
-  // All the values are suspect.  Start over.
-  m_fix.valid.init();
+  // The values from this sentence are suspect.
+  rejectFix();
   nmeaMessage = NMEA_UNKNOWN;
 
   reset();
@@ -167,6 +221,10 @@ void NMEAGPS::sentenceInvalid()
 
 void NMEAGPS::sentenceUnrecognized()
 {
+  #ifdef NMEAGPS_EXTENDED_STATS
+    statistics.unrecognized++;
+  #endif
+
   nmeaMessage = NMEA_UNKNOWN;
 
   reset();
@@ -176,10 +234,38 @@ void NMEAGPS::sentenceUnrecognized()
 
 void NMEAGPS::headerReceived()
 {
+  shadowFix();
   NMEAGPS_INIT_FIX(m_fix);
   fieldIndex = 1;
   chrCount   = 0;
-  rxState    = NMEA_RECEIVING_DATA;
+
+  #ifdef NMEAGPS_FIELD_MASKS
+    #ifdef NMEAGPS_RUNTIME_PROFILE
+      if ((nmeaMessage < 32) &&
+          !(_profile.sentences & NMEAGPS_SENTENCE( nmeaMessage )))
+        _fields = 0;
+      else
+    #endif
+        _fields = parsedFields();
+
+    bool parsing = fieldParsed( 1 );
+
+    #ifdef NMEAGPS_SATELLITE_TABLE
+      _parsed = (_fields != 0);
+    #endif
+  #else
+    bool parsing = (parsedFields() != 0);
+
+    #ifdef NMEAGPS_SATELLITE_TABLE
+      _parsed = parsing;
+    #endif
+  #endif
+
+  //  Recognized, but nothing to parse?  Then the fields only have to
+  //    be checksummed.
+  rxState = parsing ? NMEA_RECEIVING_DATA : NMEA_SKIPPING_DATA;
+  if (parsing)
+    fieldBegins();
 }
 
 //----------------------------------------------------------------
@@ -214,6 +300,12 @@ NMEAGPS::decode_t NMEAGPS::decode( char c )
           comma_needed( false );
           fieldIndex++;
           chrCount     = 0;
+          #ifdef NMEAGPS_FIELD_MASKS
+            if (!fieldParsed( fieldIndex ))
+              rxState = NMEA_SKIPPING_DATA;
+            else
+          #endif
+              fieldBegins();
         } else
           chrCount++;
 
@@ -231,6 +323,40 @@ NMEAGPS::decode_t NMEAGPS::decode( char c )
     }
 
 
+  } else if (rxState == NMEA_SKIPPING_DATA) { //---------------------------
+    // Same as RECEIVING_DATA, without calling /parseField/
+
+    if (c == '*') {
+        rxState = NMEA_RECEIVING_CRC;
+        chrCount = 0;
+
+    } else if ((' ' <= c) && (c <= '~')) {
+        crc ^= c;
+
+        #ifdef NMEAGPS_FIELD_MASKS
+          if (c == ',') {
+            // The next field may be parsed
+            fieldIndex++;
+            if (fieldParsed( fieldIndex )) {
+              chrCount = 0;
+              rxState  = NMEA_RECEIVING_DATA;
+              fieldBegins();
+            }
+          }
+        #endif
+
+    #ifdef NMEAGPS_CS_OPTIONAL
+      } else if ((c == CR) || (c == LF)) {
+        sentenceOk();
+        res = DECODE_COMPLETED;
+    #endif
+
+    } else {
+      sentenceInvalid();
+      res = DECODE_CHR_INVALID;
+    }
+
+
   } else if (rxState == NMEA_RECEIVING_HEADER) { //------------------------
 
     //  The first field is the sentence type.  It will be used
@@ -268,6 +394,9 @@ NMEAGPS::decode_t NMEAGPS::decode( char c )
       #ifdef NMEAGPS_STATS
         statistics.errors++;
       #endif
+      #ifdef NMEAGPS_EXTENDED_STATS
+        statistics.message( nmeaMessage ).errors++;
+      #endif
       sentenceInvalid();
     }
 
@@ -276,6 +405,11 @@ NMEAGPS::decode_t NMEAGPS::decode( char c )
 
     res         = DECODE_CHR_INVALID;
     nmeaMessage = NMEA_UNKNOWN;
+
+    #ifdef NMEAGPS_EXTENDED_STATS
+      if ((c != CR) && (c != LF))
+        statistics.discarded++;
+    #endif
   }
 
   return res;
@@ -302,8 +436,157 @@ NMEAGPS::decode_t NMEAGPS::handle( uint8_t c )
 
 //----------------------------------------------------------------
 
+size_t NMEAGPS::handle
+  ( const uint8_t *buf, size_t len, fix_handler_t handler, void *context )
+{
+  const uint8_t *ptr = buf;
+  const uint8_t *end = buf + len;
+
+  while (ptr < end) {
+
+    #if !defined( NMEAGPS_DERIVED_TYPES )
+      if (rxState == NMEA_IDLE) {
+        // Only a '$' can start a sentence.  Skip everything up to
+        //   the next '$' without stepping through the FSM.  Derived
+        //   types may recognize other characters (e.g., UBX binary),
+        //   so they must see every character.
+        const uint8_t *dollar = (const uint8_t *) memchr( ptr, '$', end-ptr );
+        if (dollar == (const uint8_t *) NULL)
+          dollar = end;
+
+        if (dollar != ptr) {
+          #ifdef NMEAGPS_STATS
+            statistics.chars += (dollar - ptr);
+          #endif
+          #ifdef NMEAGPS_EXTENDED_STATS
+            for (const uint8_t *c = ptr; c < dollar; c++)
+              if ((*c != CR) && (*c != LF))
+                statistics.discarded++;
+          #endif
+          nmeaMessage = NMEA_UNKNOWN;
+
+          ptr = dollar;
+          continue;
+        }
+      }
+    #endif
+
+    if ((rxState == NMEA_SKIPPING_DATA) && skippingRest()) {
+      //  The rest of a sentence that was started in a previous block,
+      //    or that is too long for NMEAframe.  Nothing will be parsed,
+      //    so just accumulate the CRC up to the '*'.
+      size_t skipped = NeoGPS::NMEAframe::skip( ptr, end-ptr, crc );
+      #ifdef NMEAGPS_STATS
+        statistics.chars += skipped;
+      #endif
+      if (skipped && (NMEAGPS_FIX_MAX == 0) && _available())
+        overrun( true ); // same as /handle( c )/
+      ptr += skipped;
+      if (ptr == end)
+        break;
+    }
+
+    decode_t res = DECODE_CHR_INVALID;
+    bool     framed = false;
+
+    if ((rxState == NMEA_IDLE) && (*ptr == '$')) {
+      // Check the whole sentence before parsing any of it.
+      NeoGPS::NMEAframe frame;
+
+      switch (frame.scan( ptr, end-ptr )) {
+
+        case NeoGPS::NMEAframe::FRAME_BAD_CRC:
+          // Reject it without touching the current fix.
+          #ifdef NMEAGPS_STATS
+            statistics.chars += frame.length;
+            statistics.errors++;
+          #endif
+          #ifdef NMEAGPS_EXTENDED_STATS
+            statistics.message( frameMessage( ptr, frame ) ).errors++;
+          #endif
+          nmeaMessage = NMEA_UNKNOWN;
+
+          ptr += frame.length;
+          continue;
+
+        case NeoGPS::NMEAframe::FRAME_OK:
+          if (frame.allCommas() && (frame.commas > 0)) {
+            // Parse the fields directly.
+            if ((NMEAGPS_FIX_MAX == 0) && _available())
+              overrun( true ); // fix() is about to change
+
+            res = decodeSentence( ptr, frame );
+            if (res == DECODE_COMPLETED)
+              storeFix();
+
+            ptr   += frame.length;
+            framed = true;
+          }
+          break;
+
+        default: // incomplete, use the FSM
+          break;
+      }
+    }
+
+    if (!framed)
+      res = handle( *ptr++ );
+
+    if (res == DECODE_COMPLETED) {
+
+      if (handler) {
+        // Pass each fix in place, without copying it.
+        const gps_fix *next;
+        while ((next = peek()) != NULL) {
+          handler( *next, context );
+          commit();
+        }
+
+      } else {
+        bool full = ((NMEAGPS_FIX_MAX == 0) && _available()) ||
+                    ((NMEAGPS_FIX_MAX >  0) && (_available() >= NMEAGPS_FIX_MAX));
+        if (full)
+          break;
+      }
+    }
+  }
+
+  return ptr - buf;
+
+} // handle
+
+//----------------------------------------------------------------
+
+void NMEAGPS::endInterval()
+{
+  #ifdef NMEAGPS_SATELLITE_TABLE
+    satellites.endInterval();
+    sat_count = satellites.count;
+  #endif
+
+  #ifdef NMEAGPS_EXTENDED_STATS
+    if (_intervalTimed) {
+      statistics.interval.add( micros() - _statsIntervalStart );
+      _intervalTimed = false;
+    }
+  #endif
+
+} // endInterval
+
+//----------------------------------------------------------------
+
 void NMEAGPS::storeFix()
 {
+  if (intervalComplete())
+    endInterval();
+
+  #ifdef NMEAGPS_TRACE_LATENCY
+    //  The sentence that completes a fix has just been parsed.
+    uint32_t lastSentence = 0;
+    if ((currentMerging() == NO_MERGING) || intervalComplete())
+      lastSentence = micros();
+  #endif
+
   // Room for another fix?
 
   bool room = ((NMEAGPS_FIX_MAX == 0) &&  !_available()) ||
@@ -316,13 +599,17 @@ void NMEAGPS::storeFix()
 
       #if NMEAGPS_FIX_MAX > 0
 
-        // Write over the oldest fix (_firstFix), so "pop" it off the front.
-        _firstFix++;
-        if (_firstFix >= NMEAGPS_FIX_MAX)
-          _firstFix = 0;
-
-        // this new one is not available until the interval is complete
-        _fixesAvailable--;
+        // Write over the oldest fix (_fixTail), so "pop" it off the front.
+        //   If the reader releases it at the same time, that's ok: there
+        //   is room either way.
+        uint8_t tail = loadIndex( _fixTail );
+        #ifdef NEOGPS_ATOMIC_INDICES
+          __atomic_compare_exchange_n( &_fixTail, &tail, (uint8_t) (tail+1),
+                                       false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+        #else
+          // The reader cannot run during an ISR (see commit)
+          storeIndex( _fixTail, tail+1 );
+        #endif
 
       #else
         // Write over the one and only fix.  It may not be complete.
@@ -339,13 +626,20 @@ void NMEAGPS::storeFix()
     //   Note: If FIX_MAX == 0, this just marks _fixesAvailable = true.
 
     #if NMEAGPS_FIX_MAX > 0
-      if (merging == EXPLICIT_MERGING) {
-        // Accumulate all sentences
-        buffer[ _currentFix ] |= fix();
+      gps_fix & currentFix = buffer[ _fixHead & FIX_MASK ];
+
+      if (currentMerging() == EXPLICIT_MERGING) {
+        // Accumulate all sentences, starting with an empty fix.  The
+        //   reader (or a dropped fix) may have left old data in it.
+        if (!_fixStarted) {
+          currentFix.init();
+          _fixStarted = true;
+        }
+        currentFix |= fix();
       }
     #endif
 
-    if ((merging == NO_MERGING) || intervalComplete()) {
+    if ((currentMerging() == NO_MERGING) || intervalComplete()) {
 
       #if defined(NMEAGPS_TIMESTAMP_FROM_INTERVAL) & \
           defined(GPS_FIX_TIME)
@@ -353,9 +647,7 @@ void NMEAGPS::storeFix()
         // If this new fix is the start of a second, save the
         //   interval start time as the start of this UTC second.
 
-        #if NMEAGPS_FIX_MAX > 0
-          gps_fix & currentFix = buffer[ _currentFix ];
-        #else
+        #if NMEAGPS_FIX_MAX == 0
           gps_fix & currentFix = m_fix;
         #endif
 
@@ -366,17 +658,28 @@ void NMEAGPS::storeFix()
 
       #if NMEAGPS_FIX_MAX > 0
 
-        if (merging != EXPLICIT_MERGING)
-          buffer[ _currentFix ] = fix();
+        if (currentMerging() != EXPLICIT_MERGING)
+          currentFix = fix();
 
-        _currentFix++;
-        if (_currentFix >= NMEAGPS_FIX_MAX)
-          _currentFix = 0;
+        #ifdef NMEAGPS_TRACE_LATENCY
+          fix_trace_t & currentTrace = _fixTraces[ _fixHead & FIX_MASK ];
+          currentTrace.firstChar    = _traceFirstChar;
+          currentTrace.lastSentence = lastSentence;
+          currentTrace.stored       = micros();
+          currentTrace.read         = 0;
+        #endif
 
-        if (_fixesAvailable < NMEAGPS_FIX_MAX)
-          _fixesAvailable++;
+        // Publish it to the reader.
+        storeIndex( _fixHead, _fixHead+1 );
+        _fixStarted = false;
 
       #else // FIX_MAX == 0
+        #ifdef NMEAGPS_TRACE_LATENCY
+          _fixTrace.firstChar    = _traceFirstChar;
+          _fixTrace.lastSentence = lastSentence;
+          _fixTrace.stored       = micros();
+          _fixTrace.read         = 0;
+        #endif
         _fixesAvailable = true;
       #endif
 
@@ -388,12 +691,24 @@ void NMEAGPS::storeFix()
 //----------------------------------------------------------------
 // NMEA Sentence strings (alphabetical)
 
+#if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+  static const char dtm[] __PROGMEM =  "DTM";
+#endif
+#if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+  static const char gbs[] __PROGMEM =  "GBS";
+#endif
 #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
   static const char gga[] __PROGMEM =  "GGA";
 #endif
 #if defined(NMEAGPS_PARSE_GLL) | defined(NMEAGPS_RECOGNIZE_ALL)
   static const char gll[] __PROGMEM =  "GLL";
 #endif
+#if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+  static const char gns[] __PROGMEM =  "GNS";
+#endif
+#if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+  static const char grs[] __PROGMEM =  "GRS";
+#endif
 #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
   static const char gsa[] __PROGMEM =  "GSA";
 #endif
@@ -403,6 +718,9 @@ void NMEAGPS::storeFix()
 #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_RECOGNIZE_ALL)
   static const char gsv[] __PROGMEM =  "GSV";
 #endif
+#if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+  static const char hdt[] __PROGMEM =  "HDT";
+#endif
 #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
   static const char rmc[] __PROGMEM =  "RMC";
 #endif
@@ -415,12 +733,24 @@ void NMEAGPS::storeFix()
 
 static const char * const std_nmea[] __PROGMEM =
   {
+    #if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+      dtm,
+    #endif
+    #if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+      gbs,
+    #endif
     #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
       gga,
     #endif
     #if defined(NMEAGPS_PARSE_GLL) | defined(NMEAGPS_RECOGNIZE_ALL)
       gll,
     #endif
+    #if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+      gns,
+    #endif
+    #if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+      grs,
+    #endif
     #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
       gsa,
     #endif
@@ -430,6 +760,9 @@ static const char * const std_nmea[] __PROGMEM =
     #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_RECOGNIZE_ALL)
       gsv,
     #endif
+    #if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+      hdt,
+    #endif
     #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
       rmc,
     #endif
@@ -452,13 +785,47 @@ const NMEAGPS::msg_table_t NMEAGPS::nmea_msg_table __PROGMEM =
     std_nmea
   };
 
+//----------------------------------------------------------------
+//  Sentence types are packed into a base-37 key, one char at a time.
+//    There is no zero digit, so keys of different lengths are unique.
+
+#define KEY_DIGIT(c) ( ((c) <= '9') ? ((c) - '0' + 1) : ((c) - 'A' + 11) )
+#define KEY3(a,b,c)  ( (KEY_DIGIT(a)*37 + KEY_DIGIT(b))*37 + KEY_DIGIT(c) )
+
+static uint8_t keyDigit( char c )
+{
+  if (('0' <= c) && (c <= '9'))
+    return KEY_DIGIT(c);
+  if (('A' <= c) && (c <= 'Z'))
+    return KEY_DIGIT(c);
+  return 0; // not allowed
+}
+
+#ifdef NMEAGPS_DERIVED_TYPES
+  static uint16_t keyFor_P( const char *str_P )
+  {
+    uint16_t key = 0;
+    for (;;) {
+      char c = pgm_read_byte( str_P++ );
+      if (!c)
+        break;
+      key = key*37 + keyDigit( c );
+    }
+    return key;
+  }
+#endif
+
 //----------------------------------------------------------------
 //  For NMEA, start with talker or manufacture ID
 
 NMEAGPS::decode_t NMEAGPS::parseCommand( char c )
 {
   if (c == ',') {
-    // End of field, did we get a sentence type yet?
+    // End of field, did we get a sentence type yet?  A derived class
+    //   may have set it from the manufacturer ID (e.g., PUBX).
+    if (cmdKey != 0)
+      nmeaMessage = findCommand( cmdKey );
+
     return
       (nmeaMessage == NMEA_UNKNOWN) ?
         DECODE_CHR_INVALID :
@@ -473,8 +840,6 @@ NMEAGPS::decode_t NMEAGPS::parseCommand( char c )
     }
   #endif
 
-  uint8_t cmdCount = chrCount;
-
   #ifdef NMEAGPS_PARSE_PROPRIETARY
     if (proprietary) {
 
@@ -492,8 +857,6 @@ NMEAGPS::decode_t NMEAGPS::parseCommand( char c )
         return DECODE_CHR_OK;
       }
 
-      cmdCount -= 4;
-
     } else
   #endif
   { // standard
@@ -504,6 +867,14 @@ NMEAGPS::decode_t NMEAGPS::parseCommand( char c )
         talker_id[chrCount] = c;
       #endif
 
+      #ifdef NMEAGPS_SATELLITE_TABLE
+        if (chrCount == 0)
+          _talkerSystem = c; // until the second char arrives
+        else
+          _talkerSystem =
+            NeoGPS::SatelliteTable_t::systemFor( (char) _talkerSystem, c );
+      #endif
+
       #ifdef NMEAGPS_PARSE_TALKER_ID
         if (!parseTalkerID( c ))
           return DECODE_CHR_INVALID;
@@ -511,114 +882,100 @@ NMEAGPS::decode_t NMEAGPS::parseCommand( char c )
 
       return DECODE_CHR_OK;
     }
-
-    cmdCount -= 2;
   }
 
-  //  The remaining characters are the message type.
+  //  The remaining characters are the message type.  Pack them into
+  //    the key, and look it up when the terminating comma arrives.
+
+  uint8_t digit = keyDigit( c );
+  if ((digit == 0) || (cmdKey > MAX_KEY2))
+    return DECODE_CHR_INVALID; // bad char, or more than 3 chars
 
-  const msg_table_t *msgs = msg_table();
+  cmdKey = cmdKey*37 + digit;
 
-  return parseCommand( msgs, cmdCount, c );
+  return DECODE_CHR_OK;
 
 } // parseCommand
 
 //----------------------------------------------------------------
-//  Determine the NMEA sentence type
+//  Determine the NMEA sentence type from the packed key.  The standard
+//    types are a switch on constant keys.  Derived tables are usually
+//    small, so their entries are packed and compared one at a time.
 
-NMEAGPS::decode_t NMEAGPS::parseCommand
-  ( const msg_table_t *msgs, uint8_t cmdCount, char c )
+NMEAGPS::nmea_msg_t NMEAGPS::findCommand( uint16_t key ) const
 {
-  for (;;) {
-    #ifdef NMEAGPS_DERIVED_TYPES
-      uint8_t  table_size       = pgm_read_byte( &msgs->size );
-      uint8_t  msg_offset       = pgm_read_byte( &msgs->offset );
-      bool     check_this_table = true;
-    #else
-      const uint8_t table_size       = sizeof(std_nmea)/sizeof(std_nmea[0]);
-      const uint8_t msg_offset       = NMEA_FIRST_MSG;
-      const bool    check_this_table = true;
-    #endif
-    decode_t res              = DECODE_CHR_INVALID;
-    uint8_t  entry;
-
-    if (nmeaMessage == NMEA_UNKNOWN) {
-      // We're just starting
-      entry = 0;
-
-    } else if ((msg_offset <= nmeaMessage) && (nmeaMessage < msg_offset+table_size)) {
-      // In range of this table, pick up where we left off
-      entry = nmeaMessage - msg_offset;
-    }
-    #ifdef NMEAGPS_DERIVED_TYPES
-      else
-        check_this_table = false;
-    #endif
-
-    if (check_this_table) {
-      uint8_t i = entry;
-
-      #if !defined( NMEAGPS_DERIVED_TYPES )
-        const char * const *table   = std_nmea;
-      #else
-        const char * const *table   = (const char * const *) pgm_read_ptr( &msgs->table );
-      #endif
-      const char *        table_i = (const char *        ) pgm_read_ptr( &table[i] );
-
-      for (;;) {
-        char rc = pgm_read_byte( &table_i[cmdCount] );
-        if (c == rc) {
-          // ok so far...
-          entry = i;
-          res   = DECODE_CHR_OK;
-          break;
-        }
-
-        if (c < rc) {
-          // Alphabetical rejection, check next table
-          break;
-        }
+  #ifdef NMEAGPS_DERIVED_TYPES
+    const msg_table_t *msgs = msg_table();
 
-        // Ok to check another entry in this table
-        uint8_t next_msg = i+1;
-        if (next_msg >= table_size) {
-          // No more entries in this table.
-          break;
+    for (;;) {
+      if (msgs != &nmea_msg_table) {
+        uint8_t             table_size = pgm_read_byte( &msgs->size );
+        uint8_t             msg_offset = pgm_read_byte( &msgs->offset );
+        const char * const *table      =
+          (const char * const *) pgm_read_ptr( &msgs->table );
+
+        for (uint8_t i=0; i < table_size; i++) {
+          const char *table_i = (const char *) pgm_read_ptr( &table[i] );
+          if (keyFor_P( table_i ) == key)
+            return (nmea_msg_t) (msg_offset + i);
         }
 
-        //  See if the next entry starts with the same characters.
-        const char *table_next = (const char *) pgm_read_ptr( &table[next_msg] );
-
-        for (uint8_t j = 0; j < cmdCount; j++)
-          if (pgm_read_byte( &table_i[j] ) != pgm_read_byte( &table_next[j] )) {
-            // Nope, a different start to this entry
-            break;
-          }
-        i = next_msg;
-        table_i = table_next;
-      }
-    }
-
-    if (res == DECODE_CHR_INVALID) {
-
-      #ifdef NMEAGPS_DERIVED_TYPES
+        // Try the previous table
         msgs = (const msg_table_t *) pgm_read_ptr( &msgs->previous );
-        if (msgs) {
-          // Try the current character in the previous table
+        if (msgs)
           continue;
-        } // else
-          // No more tables, chr is invalid.
-      #endif
 
-    } else {
-      //  This entry is good so far.
-      nmeaMessage = (nmea_msg_t) (entry + msg_offset);
+        return NMEA_UNKNOWN;
+      }
+      break; // standard table
     }
+  #endif
 
-    return res;
+  switch (key) {
+    #if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('D','T','M'): return NMEA_DTM;
+    #endif
+    #if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','B','S'): return NMEA_GBS;
+    #endif
+    #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','G','A'): return NMEA_GGA;
+    #endif
+    #if defined(NMEAGPS_PARSE_GLL) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','L','L'): return NMEA_GLL;
+    #endif
+    #if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','N','S'): return NMEA_GNS;
+    #endif
+    #if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','R','S'): return NMEA_GRS;
+    #endif
+    #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','S','A'): return NMEA_GSA;
+    #endif
+    #if defined(NMEAGPS_PARSE_GST) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','S','T'): return NMEA_GST;
+    #endif
+    #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('G','S','V'): return NMEA_GSV;
+    #endif
+    #if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('H','D','T'): return NMEA_HDT;
+    #endif
+    #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('R','M','C'): return NMEA_RMC;
+    #endif
+    #if defined(NMEAGPS_PARSE_VTG) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('V','T','G'): return NMEA_VTG;
+    #endif
+    #if defined(NMEAGPS_PARSE_ZDA) | defined(NMEAGPS_RECOGNIZE_ALL)
+      case KEY3('Z','D','A'): return NMEA_ZDA;
+    #endif
   }
 
-} // parseCommand
+  return NMEA_UNKNOWN;
+
+} // findCommand
 
 //----------------------------------------------------------------
 
@@ -668,66 +1025,709 @@ const __FlashStringHelper *NMEAGPS::string_for( nmea_msg_t msg ) const
 
 bool NMEAGPS::parseField(char chr)
 {
-    switch (nmeaMessage) {
+  if (_converter != FIELD_SKIP)
+    return parseConverter( _converter, chr );
+
+  // These sentences are not described by a schema.
+
+  switch (nmeaMessage) {
+
+    #if defined(NMEAGPS_PARSE_GSA)
+      case NMEA_GSA: return parseGSA( chr );
+    #endif
+
+    #if defined(NMEAGPS_PARSE_GSV)
+      case NMEA_GSV: return parseGSV( chr );
+    #endif
+
+    default:
+        break;
+  }
+
+  return true;
+
+} // parseField
+
+//----------------------------------------------------------------
+
+bool NMEAGPS::parseConverter( uint8_t field, char chr )
+{
+  switch (field) {
+    case FIELD_TIME        : return parseTime       ( chr );
+    case FIELD_DDMMYY      : return parseDDMMYY     ( chr );
+    case FIELD_FIX         : return parseFix        ( chr );
+    case FIELD_LAT         : return parseLat        ( chr );
+    case FIELD_NS          : return parseNS         ( chr );
+    case FIELD_LON         : return parseLon        ( chr );
+    case FIELD_EW          : return parseEW         ( chr );
+    case FIELD_SPEED       : return parseSpeed      ( chr );
+    case FIELD_SPEED_KPH   : return parseSpeedKph   ( chr );
+    case FIELD_HEADING     : return parseHeading    ( chr );
+    case FIELD_ALT         : return parseAlt        ( chr );
+    case FIELD_GEOID_HEIGHT: return parseGeoidHeight( chr );
+    case FIELD_SATELLITES  : return parseSatellites ( chr );
+    case FIELD_HDOP        : return parseHDOP       ( chr );
+    case FIELD_VDOP        : return parseVDOP       ( chr );
+    case FIELD_PDOP        : return parsePDOP       ( chr );
+    case FIELD_LAT_ERR     : return parse_lat_err   ( chr );
+    case FIELD_LON_ERR     : return parse_lon_err   ( chr );
+    case FIELD_ALT_ERR     : return parse_alt_err   ( chr );
+    case FIELD_ZDA_DATE    : return parseZDA        ( chr );
+    case FIELD_GNS_MODE    : return parseGNSMode    ( chr );
+    case FIELD_TRUE_HEADING: return parseTrueHeading( chr );
+    case FIELD_DATUM       : return parseDatum      ( chr );
+    default:
+      break;
+  }
+
+  return true;
+
+} // parseConverter
+
+//----------------------------------------------------------------
+//  The schema of each standard sentence, in nmea_msg_t order.  A field
+//    index that is not listed (or FIELD_SKIP) has nothing to parse.
+
+#define SCHEMA(fields) { sizeof(fields), fields }
+#define NO_SCHEMA      { 0, (const uint8_t *) NULL }
+
+const NMEAGPS::schema_t *NMEAGPS::schemaFor( nmea_msg_t msg )
+{
+  #if defined(NMEAGPS_PARSE_DTM)
+    static const uint8_t dtm[] __PROGMEM =
+      { FIELD_SKIP, FIELD_DATUM };
+        // The offsets and the reference datum are not saved.
+  #endif
+
+  #if defined(NMEAGPS_PARSE_GBS)
+    static const uint8_t gbs[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME,
+        FIELD_LAT_ERR, FIELD_LON_ERR, FIELD_ALT_ERR };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_GGA)
+    static const uint8_t gga[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME,
+        FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+        FIELD_FIX, FIELD_SATELLITES, FIELD_HDOP, FIELD_ALT,
+        FIELD_SKIP, FIELD_GEOID_HEIGHT };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_GLL)
+    static const uint8_t gll[] __PROGMEM =
+      { FIELD_SKIP,
+        FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+        FIELD_TIME, FIELD_SKIP, FIELD_FIX };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_GNS)
+    static const uint8_t gns[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME,
+        FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+        FIELD_GNS_MODE, FIELD_SATELLITES, FIELD_HDOP, FIELD_ALT,
+        FIELD_GEOID_HEIGHT };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_GRS)
+    static const uint8_t grs[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME };
+        // The range residuals are not saved.
+  #endif
+
+  #if defined(NMEAGPS_PARSE_GST)
+    static const uint8_t gst[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME,
+        FIELD_SKIP, FIELD_SKIP, FIELD_SKIP, FIELD_SKIP,
+        FIELD_LAT_ERR, FIELD_LON_ERR, FIELD_ALT_ERR };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_HDT)
+    static const uint8_t hdt[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TRUE_HEADING };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_RMC)
+    static const uint8_t rmc[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME, FIELD_FIX,
+        FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+        FIELD_SPEED, FIELD_HEADING, FIELD_DDMMYY };
+        // field 12 is the fix mode, ublox only!
+  #endif
+
+  #if defined(NMEAGPS_PARSE_VTG)
+    static const uint8_t vtg[] __PROGMEM =
+      { FIELD_SKIP, FIELD_HEADING,
+        FIELD_SKIP, FIELD_SKIP, FIELD_SKIP, FIELD_SPEED,
+        FIELD_SKIP, FIELD_SKIP, FIELD_SKIP, FIELD_FIX };
+  #endif
+
+  #if defined(NMEAGPS_PARSE_ZDA)
+    static const uint8_t zda[] __PROGMEM =
+      { FIELD_SKIP, FIELD_TIME,
+        FIELD_ZDA_DATE, FIELD_ZDA_DATE, FIELD_ZDA_DATE };
+  #endif
+
+  static const schema_t nmea_schemas[] __PROGMEM =
+    {
+      NO_SCHEMA, // NMEA_UNKNOWN
+
+      #if defined(NMEAGPS_PARSE_DTM)
+        SCHEMA( dtm ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
+      #endif
+
+      #if defined(NMEAGPS_PARSE_GBS)
+        SCHEMA( gbs ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
+      #endif
 
       #if defined(NMEAGPS_PARSE_GGA)
-        case NMEA_GGA: return parseGGA( chr );
+        SCHEMA( gga ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
 
       #if defined(NMEAGPS_PARSE_GLL)
-        case NMEA_GLL: return parseGLL( chr );
+        SCHEMA( gll ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
 
-      #if defined(NMEAGPS_PARSE_GSA)
-        case NMEA_GSA: return parseGSA( chr );
+      #if defined(NMEAGPS_PARSE_GNS)
+        SCHEMA( gns ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
+      #endif
+
+      #if defined(NMEAGPS_PARSE_GRS)
+        SCHEMA( grs ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
+      #endif
+
+      #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA, // see parseGSA
       #endif
 
       #if defined(NMEAGPS_PARSE_GST)
-        case NMEA_GST: return parseGST( chr );
+        SCHEMA( gst ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
 
-      #if defined(NMEAGPS_PARSE_GSV)
-        case NMEA_GSV: return parseGSV( chr );
+      #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA, // see parseGSV
+      #endif
+
+      #if defined(NMEAGPS_PARSE_HDT)
+        SCHEMA( hdt ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
 
       #if defined(NMEAGPS_PARSE_RMC)
-        case NMEA_RMC: return parseRMC( chr );
+        SCHEMA( rmc ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
 
       #if defined(NMEAGPS_PARSE_VTG)
-        case NMEA_VTG: return parseVTG( chr );
+        SCHEMA( vtg ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
 
       #if defined(NMEAGPS_PARSE_ZDA)
-        case NMEA_ZDA: return parseZDA( chr );
+        SCHEMA( zda ),
+      #elif defined(NMEAGPS_RECOGNIZE_ALL)
+        NO_SCHEMA,
       #endif
+    };
+
+  if (msg >= NMEAMSG_END)
+    return (const schema_t *) NULL; // a derived type
+
+  const schema_t *schema = &nmea_schemas[ msg ];
+  if (pgm_read_byte( &schema->count ) == 0)
+    return (const schema_t *) NULL;
+
+  return schema;
+
+} // schemaFor
+
+
+//----------------------------------------------------------------
+//  Each mask has a bit set for the fields that have something to
+//    parse, according to the schemas above.  If a fix member is not
+//    enabled in GPSfix_cfg.h, its converter (and field) is skipped.
+
+#define FIELD(i) (1UL << (i))
+
+#ifdef GPS_FIX_TIME
+  static const uint32_t TIME_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t TIME_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_DATE
+  static const uint32_t DATE_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t DATE_FIELDS = 0;
+#endif
+#if defined( GPS_FIX_LOCATION ) | defined( GPS_FIX_LOCATION_DMS )
+  static const uint32_t LOC_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t LOC_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_ALTITUDE
+  static const uint32_t ALT_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t ALT_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_GEOID_HEIGHT
+  static const uint32_t GEOID_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t GEOID_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_SPEED
+  static const uint32_t SPEED_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t SPEED_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_HEADING
+  static const uint32_t HEADING_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t HEADING_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_TRUE_HEADING
+  static const uint32_t TRUE_HDG_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t TRUE_HDG_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_SATELLITES
+  static const uint32_t SATS_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t SATS_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_HDOP
+  static const uint32_t HDOP_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t HDOP_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_VDOP
+  static const uint32_t VDOP_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t VDOP_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_PDOP
+  static const uint32_t PDOP_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t PDOP_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_LAT_ERR
+  static const uint32_t LAT_ERR_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t LAT_ERR_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_LON_ERR
+  static const uint32_t LON_ERR_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t LON_ERR_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_ALT_ERR
+  static const uint32_t ALT_ERR_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t ALT_ERR_FIELDS = 0;
+#endif
+#ifdef GPS_FIX_DATUM
+  static const uint32_t DATUM_FIELDS = 0xFFFFFFFFUL;
+#else
+  static const uint32_t DATUM_FIELDS = 0;
+#endif
+
+uint32_t NMEAGPS::schemaMask
+  ( const schema_t *schema, uint32_t converters ) const
+{
+  //  The converters that set something, according to GPSfix_cfg.h
+  static const uint32_t CONVERTERS =
+     FIELD(FIELD_FIX)                                       |
+     FIELD(FIELD_GNS_MODE)                                  |
+    (FIELD(FIELD_TIME)                    & TIME_FIELDS   ) |
+    ((FIELD(FIELD_DDMMYY) |
+      FIELD(FIELD_ZDA_DATE))              & DATE_FIELDS   ) |
+    ((FIELD(FIELD_LAT) | FIELD(FIELD_NS) |
+      FIELD(FIELD_LON) | FIELD(FIELD_EW)) & LOC_FIELDS    ) |
+    ((FIELD(FIELD_SPEED) |
+      FIELD(FIELD_SPEED_KPH))             & SPEED_FIELDS  ) |
+    (FIELD(FIELD_HEADING)                 & HEADING_FIELDS) |
+    (FIELD(FIELD_TRUE_HEADING)            & TRUE_HDG_FIELDS) |
+    (FIELD(FIELD_ALT)                     & ALT_FIELDS    ) |
+    (FIELD(FIELD_GEOID_HEIGHT)            & GEOID_FIELDS  ) |
+    (FIELD(FIELD_SATELLITES)              & SATS_FIELDS   ) |
+    (FIELD(FIELD_HDOP)                    & HDOP_FIELDS   ) |
+    (FIELD(FIELD_VDOP)                    & VDOP_FIELDS   ) |
+    (FIELD(FIELD_PDOP)                    & PDOP_FIELDS   ) |
+    (FIELD(FIELD_LAT_ERR)                 & LAT_ERR_FIELDS) |
+    (FIELD(FIELD_LON_ERR)                 & LON_ERR_FIELDS) |
+    (FIELD(FIELD_ALT_ERR)                 & ALT_ERR_FIELDS) |
+    (FIELD(FIELD_DATUM)                   & DATUM_FIELDS  );
+
+  converters &= CONVERTERS;
+  #ifdef NMEAGPS_RUNTIME_PROFILE
+    converters &= _converters;
+  #endif
+
+  uint8_t        count  = pgm_read_byte( &schema->count );
+  const uint8_t *fields = (const uint8_t *) pgm_read_ptr( &schema->fields );
+  uint32_t       mask   = 0;
+
+  for (uint8_t i=0; i < count; i++) {
+    uint8_t field = pgm_read_byte( &fields[i] );
+    if ((field >= FIELD_DERIVED) || (converters & FIELD(field)))
+      mask |= FIELD(i);
+  }
+
+  return mask;
+
+} // schemaMask
+
+//----------------------------------------------------------------
+
+#ifdef NMEAGPS_RUNTIME_PROFILE
+
+bool NMEAGPS::profile( const profile_t & p )
+{
+  //  Implicit merging is done by the converters (see NMEAGPS_INVALIDATE),
+  //    and explicit merging is done in the fix buffer.
+  bool possible;
+  if (merging == IMPLICIT_MERGING)
+    possible = (p.merging == IMPLICIT_MERGING);
+  else if (p.merging == EXPLICIT_MERGING)
+    possible = (NMEAGPS_FIX_MAX > 0);
+  else
+    possible = (p.merging == NO_MERGING);
+
+  if (!possible)
+    return false;
+
+  _profile = p;
+
+  //  The converters for the selected members.  The configured ones
+  //    are checked by /schemaMask/.
+
+  const gps_fix::valid_t & members = p.members;
+  uint32_t                 converters = 0;
+
+  if (members.status)
+    converters |= FIELD(FIELD_FIX) | FIELD(FIELD_GNS_MODE);
+  #ifdef GPS_FIX_TIME
+    if (members.time)
+      converters |= FIELD(FIELD_TIME);
+  #endif
+  #ifdef GPS_FIX_DATE
+    if (members.date)
+      converters |= FIELD(FIELD_DDMMYY) | FIELD(FIELD_ZDA_DATE);
+  #endif
+  #if defined( GPS_FIX_LOCATION ) | defined( GPS_FIX_LOCATION_DMS )
+    if (members.location)
+      converters |= FIELD(FIELD_LAT) | FIELD(FIELD_NS) |
+                    FIELD(FIELD_LON) | FIELD(FIELD_EW);
+  #endif
+  #ifdef GPS_FIX_SPEED
+    if (members.speed)
+      converters |= FIELD(FIELD_SPEED) | FIELD(FIELD_SPEED_KPH);
+  #endif
+  #ifdef GPS_FIX_HEADING
+    if (members.heading)
+      converters |= FIELD(FIELD_HEADING);
+  #endif
+  #ifdef GPS_FIX_TRUE_HEADING
+    if (members.trueHeading)
+      converters |= FIELD(FIELD_TRUE_HEADING);
+  #endif
+  #ifdef GPS_FIX_ALTITUDE
+    if (members.altitude)
+      converters |= FIELD(FIELD_ALT);
+  #endif
+  #ifdef GPS_FIX_GEOID_HEIGHT
+    if (members.geoidHeight)
+      converters |= FIELD(FIELD_GEOID_HEIGHT);
+  #endif
+  #ifdef GPS_FIX_SATELLITES
+    if (members.satellites)
+      converters |= FIELD(FIELD_SATELLITES);
+  #endif
+  #ifdef GPS_FIX_HDOP
+    if (members.hdop)
+      converters |= FIELD(FIELD_HDOP);
+  #endif
+  #ifdef GPS_FIX_VDOP
+    if (members.vdop)
+      converters |= FIELD(FIELD_VDOP);
+  #endif
+  #ifdef GPS_FIX_PDOP
+    if (members.pdop)
+      converters |= FIELD(FIELD_PDOP);
+  #endif
+  #ifdef GPS_FIX_LAT_ERR
+    if (members.lat_err)
+      converters |= FIELD(FIELD_LAT_ERR);
+  #endif
+  #ifdef GPS_FIX_LON_ERR
+    if (members.lon_err)
+      converters |= FIELD(FIELD_LON_ERR);
+  #endif
+  #ifdef GPS_FIX_ALT_ERR
+    if (members.alt_err)
+      converters |= FIELD(FIELD_ALT_ERR);
+  #endif
+  #ifdef GPS_FIX_DATUM
+    if (members.datum)
+      converters |= FIELD(FIELD_DATUM);
+  #endif
+
+  _converters = converters;
+
+  #if NMEAGPS_FIX_MAX > 0
+    _fixStarted = false; // the merging may be different
+  #endif
+
+  return true;
+
+} // profile
+
+#endif
+
+//----------------------------------------------------------------
+
+uint32_t NMEAGPS::parsedFields() const
+{
+  return standardFields( 0xFFFFFFFFUL );
+
+} // parsedFields
+
+//----------------------------------------------------------------
+
+uint32_t NMEAGPS::standardFields( uint32_t converters ) const
+{
+  const schema_t *schema = schemaFor( nmeaMessage );
+  if (schema)
+    return schemaMask( schema, converters );
+
+  switch (nmeaMessage) {
+
+    #if defined(NMEAGPS_PARSE_GSA)
+      case NMEA_GSA:
+        #ifdef NMEAGPS_FIELD_MASKS
+        {
+          //  The satellite IDs are always parsed, but the status and
+          //    DOPs are skipped if their converters are not selected.
+          //    The PDOP field may also finalize the satellite count.
+          #ifdef NMEAGPS_RUNTIME_PROFILE
+            converters &= _converters;
+          #endif
+          uint32_t fields = 0xFFFFFFFFUL;
+          if (!(converters & FIELD(FIELD_FIX)))
+            fields &= ~FIELD(2);
+          #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_SATELLITE_TABLE)
+            if (!(converters & FIELD(FIELD_PDOP)))
+              fields &= ~FIELD(15);
+          #endif
+          if (!(converters & FIELD(FIELD_HDOP)))
+            fields &= ~FIELD(16);
+          if (!(converters & FIELD(FIELD_VDOP)))
+            fields &= ~FIELD(17);
+          return fields;
+        }
+        #else
+          return 0xFFFFFFFFUL; // status, DOPs and satellite IDs
+        #endif
+    #endif
+
+    #if defined(NMEAGPS_PARSE_GSV)
+      case NMEA_GSV:
+        #ifdef NMEAGPS_PARSE_SATELLITES
+          return 0xFFFFFFFFUL;
+        #else
+          return 0;
+        #endif
+    #endif
+
+    default:
+      break;
+  }
+
+  // Recognized, but not parsed.  Derived sentence types are
+  //   parsed by the derived /parseField/.
+  return (nmeaMessage > NMEA_LAST_MSG) ? 0xFFFFFFFFUL : 0;
+
+} // standardFields
+
+//----------------------------------------------------------------
+
+NMEAGPS::decode_t NMEAGPS::decodeSentence
+  ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame )
+{
+  decode_t res = decodeHeader( sentence, frame );
+
+  if (rxState == NMEA_RECEIVING_DATA)
+    res = decodeFields( sentence, frame );
+
+  return res;
+
+} // decodeSentence
+
+//----------------------------------------------------------------
+
+NMEAGPS::decode_t NMEAGPS::decodeHeader
+  ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame )
+{
+  decode_t res = DECODE_CHR_OK;
+  uint8_t  i   = 0;
+
+  //  The '$' and the sentence type go through the FSM, so that
+  //    derived classes see them.
+
+  uint8_t headerEnd = frame.fieldEnd( 0 );
+  while (i <= headerEnd)
+    res = decode( sentence[i++] );
+
+  if (rxState == NMEA_SKIPPING_DATA) {
+    if (skippingRest()) {
+      //  Recognized, but nothing to parse.  The frame has already been
+      //    checked, so the fields don't have to be decoded at all.
+      #ifdef NMEAGPS_STATS
+        statistics.chars += frame.length - i;
+      #endif
+      frameOk( frame );
+      res = DECODE_COMPLETED;
+    } else
+      //  Some fields are parsed.  /decodeFields/ skips the others.
+      rxState = NMEA_RECEIVING_DATA;
+
+  } else if (rxState != NMEA_RECEIVING_DATA) {
+    //  Not recognized, or not accepted.  The rest is ignored.
+    while (i < frame.length)
+      res = decode( sentence[i++] );
+  }
+
+  return res;
+
+} // decodeHeader
+
+//----------------------------------------------------------------
+
+NMEAGPS::decode_t NMEAGPS::decodeFields
+  ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame )
+{
+  #ifdef NMEAGPS_STATS
+    statistics.chars += frame.length - frame.fieldStart( 1 );
+  #endif
+
+  //  Parse the fields, skipping the ones that don't set anything.
+
+  uint32_t fields = sentenceFields();
+
+  for (uint8_t f=1; f <= frame.commas; f++) {
+    uint8_t end  = frame.fieldEnd( f );
+
+    if (fields & FIELD(f)) {
+      uint8_t i = frame.fieldStart( f );
+
+      #ifdef NMEAGPS_SWAR_FIELDS
+        //  Try to parse the whole field at once.  The last field has
+        //    no comma, so it always goes through /parseField/.
+        if ((end != frame.crcIndex) &&
+            parseSlice( &sentence[i], end - i, frame.length - i )) {
+          fieldIndex++;
+          chrCount = 0;
+          continue;
+        }
+      #endif
+
+      fieldBegins();
+      for (; i < end; i++) {
+        if (!parseField( sentence[i] ))
+          sentenceInvalid();
+        if (rxState != NMEA_RECEIVING_DATA)
+          return DECODE_CHR_INVALID;
+        chrCount++;
+      }
+
+      if (end == frame.crcIndex)
+        break; // last field has no comma
+
+      if (!parseField( ',' ))
+        sentenceInvalid();
+      if (rxState != NMEA_RECEIVING_DATA)
+        return DECODE_CHR_INVALID;
+      comma_needed( false );
+
+    } else if (end == frame.crcIndex)
+      break;
+
+    fieldIndex++;
+    chrCount = 0;
+  }
+
+  //  Leave the FSM as if the CRC chars had been received.
+
+  frameOk( frame );
+
+  return DECODE_COMPLETED;
+
+} // decodeFields
+
+//----------------------------------------------------------------
+
+void NMEAGPS::frameOk( const NeoGPS::NMEAframe & frame )
+{
+  crc      = frame.crc;
+  rxState  = NMEA_RECEIVING_CRC;
+  chrCount = 1;
+  sentenceOk();
+
+} // frameOk
+
+//----------------------------------------------------------------
+
+#ifdef NMEAGPS_EXTENDED_STATS
 
-      default:
-          break;
-    }
+NMEAGPS::nmea_msg_t NMEAGPS::frameMessage
+  ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame ) const
+{
+  uint8_t headerEnd = frame.fieldEnd( 0 );
+
+  //  Skip the '$' and the talker ID
+  if ((headerEnd < 4) || (sentence[1] == 'P'))
+    return NMEA_UNKNOWN;
+
+  uint16_t key = 0;
+  for (uint8_t i=3; i < headerEnd; i++) {
+    uint8_t digit = keyDigit( sentence[i] );
+    if ((digit == 0) || (key > MAX_KEY2))
+      return NMEA_UNKNOWN;
+    key = key*37 + digit;
+  }
 
-    return true;
+  return findCommand( key );
 
-} // parseField
+} // frameMessage
+
+#endif
 
 //----------------------------------------------------------------
 
 bool NMEAGPS::parseGGA( char chr )
 {
   #ifdef NMEAGPS_PARSE_GGA
-    switch (fieldIndex) {
-        case  1: return parseTime( chr );
-        PARSE_LOC(2);
-        case  6: return parseFix( chr );
-        case  7: return parseSatellites( chr );
-        case  8: return parseHDOP( chr );
-        case  9: return parseAlt( chr );
-        case 11: return parseGeoidHeight( chr );
-    }
+    return parseConverter( schemaField( schemaFor( NMEA_GGA ), fieldIndex ), chr );
+  #else
+    (void) chr;
+    return true;
   #endif
 
-  return true;
-
 } // parseGGA
 
 //----------------------------------------------------------------
@@ -735,15 +1735,12 @@ bool NMEAGPS::parseGGA( char chr )
 bool NMEAGPS::parseGLL( char chr )
 {
   #ifdef NMEAGPS_PARSE_GLL
-    switch (fieldIndex) {
-        PARSE_LOC(1);
-        case 5: return parseTime( chr );
-        case 7: return parseFix( chr );
-    }
+    return parseConverter( schemaField( schemaFor( NMEA_GLL ), fieldIndex ), chr );
+  #else
+    (void) chr;
+    return true;
   #endif
 
-  return true;
-
 } // parseGLL
 
 //----------------------------------------------------------------
@@ -767,7 +1764,7 @@ bool NMEAGPS::parseGSA( char chr )
         break;
 
       case 15:
-        #if !defined( NMEAGPS_PARSE_GSV )
+        #if !defined( NMEAGPS_PARSE_GSV ) & !defined( NMEAGPS_SATELLITE_TABLE )
           // Finalize the satellite count (for the fix *and* the satellites array)
           if (chrCount == 0) {
             if (sat_count >= NMEAGPS_MAX_SATELLITES)
@@ -786,7 +1783,27 @@ bool NMEAGPS::parseGSA( char chr )
            #error When GSA and VDOP are enabled, you must define NMEAGPS_COMMA_NEEDED in NMEAGPS_cfg.h!
          #endif
 
-      #ifdef NMEAGPS_PARSE_SATELLITES
+      #if defined(NMEAGPS_SATELLITE_TABLE)
+
+        // The satellite ID fields mark the satellites used in the
+        // solution, even if GSV is enabled.  They are added to the
+        // table by satellitesOk.
+
+        case 1:
+          if (chrCount == 0)
+            memset( &_gsa, 0, sizeof(_gsa) );
+          break;
+
+        case 18: // NMEA 4.10
+          parseInt( _gsa.systemID, chr );
+          break;
+
+        default:
+          if ((3 <= fieldIndex) && (fieldIndex <= 14))
+            parseInt( _gsa.id[ fieldIndex-3 ], chr );
+          break;
+
+      #elif defined(NMEAGPS_PARSE_SATELLITES)
 
         // It's not clear how this sentence relates to GSV and GGA.
         // GSA only allows 12 satellites, while GSV allows any number.
@@ -836,23 +1853,48 @@ bool NMEAGPS::parseGSA( char chr )
 bool NMEAGPS::parseGST( char chr )
 {
   #ifdef NMEAGPS_PARSE_GST
-    switch (fieldIndex) {
-      case 1: return parseTime( chr );
-      case 6: return parse_lat_err( chr );
-      case 7: return parse_lon_err( chr );
-      case 8: return parse_alt_err( chr );
-    }
+    return parseConverter( schemaField( schemaFor( NMEA_GST ), fieldIndex ), chr );
+  #else
+    (void) chr;
+    return true;
   #endif
 
-  return true;
-
 } // parseGST
 
 //----------------------------------------------------------------
 
 bool NMEAGPS::parseGSV( char chr )
 {
-  #if defined(NMEAGPS_PARSE_GSV) & defined(NMEAGPS_PARSE_SATELLITES)
+  #if defined(NMEAGPS_PARSE_GSV) & defined(NMEAGPS_SATELLITE_TABLE)
+
+    // Each page is collected here and added to the satellite table
+    //   by satellitesOk.  A trailing NMEA 4.10 signal ID is
+    //   parsed like the ID of a fifth satellite.
+
+    if (fieldIndex == 1) {
+      if (chrCount == 0)
+        memset( &_gsv, 0, sizeof(_gsv) );
+
+    } else if (fieldIndex >= 4) {
+      uint8_t i = (fieldIndex - 4) / 4;
+
+      if (i < 4) {
+        switch (fieldIndex % 4) {
+          case 0: parseInt( _gsv.id       [i], chr ); break;
+          case 1: parseInt( _gsv.elevation[i], chr ); break;
+          case 2: parseInt( _gsv.azimuth  [i], chr ); break;
+          case 3:
+            if (chr != ',') {
+              _gsv.tracked |= (1 << i);
+              parseInt( _gsv.snr[i], chr );
+            }
+            break;
+        }
+      } else if ((i == 4) && (fieldIndex % 4 == 0))
+        parseInt( _gsv.id[i], chr );
+    }
+
+  #elif defined(NMEAGPS_PARSE_GSV) & defined(NMEAGPS_PARSE_SATELLITES)
     #if !defined(NMEAGPS_PARSE_GSA) & !defined(NMEAGPS_PARSE_GGA)
       if ((sat_count == 0) && (fieldIndex == 1) && (chrCount == 0)) {
         NMEAGPS_INVALIDATE( satellites );
@@ -923,22 +1965,86 @@ bool NMEAGPS::parseGSV( char chr )
 } // parseGSV
 
 //----------------------------------------------------------------
+//  A GSV or GSA sentence was received with a good CRC.  Add its
+//    satellites to the table.
 
-bool NMEAGPS::parseRMC( char chr )
+#ifdef NMEAGPS_SATELLITE_TABLE
+
+void NMEAGPS::satellitesOk()
 {
-  #ifdef NMEAGPS_PARSE_RMC
-    switch (fieldIndex) {
-      case 1:  return parseTime   ( chr );
-      case 2:  return parseFix    ( chr );
-      PARSE_LOC(3);
-      case 7:  return parseSpeed  ( chr );
-      case 8:  return parseHeading( chr );
-      case 9:  return parseDDMMYY ( chr );
-      // case 12: return parseFix    ( chr );  ublox only!
+  typedef NeoGPS::SatelliteTable_t table_t;
+
+  #ifdef NMEAGPS_PARSE_GSV
+    if (nmeaMessage == NMEA_GSV) {
+
+      //  Each satellite has 4 fields, starting at field 4.  If the last
+      //    field is by itself, it is the NMEA 4.10 signal ID.
+      uint8_t count  = 0;
+      uint8_t signal = 0;
+      if (fieldIndex >= 4) {
+        count = (fieldIndex - 4) / 4;
+        if (fieldIndex % 4 == 0) {
+          if (count < 5)
+            signal = _gsv.id[ count ];
+        } else
+          count++;
+        if (count > 4)
+          count = 4;
+      }
+
+      for (uint8_t i=0; i < count; i++) {
+        uint8_t id = _gsv.id[i];
+        if (id != 0)
+          satellites.update
+            ( table_t::systemFor( _talkerSystem, id ), id, signal,
+              _gsv.elevation[i], _gsv.azimuth[i], _gsv.snr[i],
+              (_gsv.tracked & (1 << i)) );
+      }
+      satellites.reported(); // even if there are none
+
+      #if !defined(NMEAGPS_PARSE_GSA) & !defined(NMEAGPS_PARSE_GGA)
+        m_fix.satellites       = satellites.tracked();
+        m_fix.valid.satellites = (m_fix.satellites > 0);
+      #endif
     }
   #endif
 
-  return true;
+  #ifdef NMEAGPS_PARSE_GSA
+    if (nmeaMessage == NMEA_GSA) {
+
+      uint8_t system = table_t::systemForID( _gsa.systemID );
+      if (system == table_t::SYS_UNKNOWN)
+        system = _talkerSystem;
+
+      for (uint8_t i=0; i < sizeof(_gsa.id); i++) {
+        uint8_t id = _gsa.id[i];
+        if (id != 0)
+          satellites.used( table_t::systemFor( system, id ), id );
+      }
+
+      #ifndef NMEAGPS_PARSE_GGA
+        m_fix.satellites       = satellites.listed();
+        m_fix.valid.satellites = (m_fix.satellites > 0);
+      #endif
+    }
+  #endif
+
+  sat_count = satellites.count;
+
+} // satellitesOk
+
+#endif
+
+//----------------------------------------------------------------
+
+bool NMEAGPS::parseRMC( char chr )
+{
+  #ifdef NMEAGPS_PARSE_RMC
+    return parseConverter( schemaField( schemaFor( NMEA_RMC ), fieldIndex ), chr );
+  #else
+    (void) chr;
+    return true;
+  #endif
 
 } // parseRMC
 
@@ -947,15 +2053,12 @@ bool NMEAGPS::parseRMC( char chr )
 bool NMEAGPS::parseVTG( char chr )
 {
   #ifdef NMEAGPS_PARSE_VTG
-    switch (fieldIndex) {
-      case 1: return parseHeading( chr );
-      case 5: return parseSpeed( chr );
-      case 9: return parseFix( chr );
-    }
+    return parseConverter( schemaField( schemaFor( NMEA_VTG ), fieldIndex ), chr );
+  #else
+    (void) chr;
+    return true;
   #endif
 
-  return true;
-
 } // parseVTG
 
 //----------------------------------------------------------------
@@ -1244,6 +2347,48 @@ bool NMEAGPS::parseFix( char chr )
 
 } // parseFix
 
+//----------------------------------------------------------------
+//  The GNS mode field has one character for each GNSS (e.g., "AAN"
+//    for GPS, GLONASS and Galileo).  The fix status is the best of them.
+
+bool NMEAGPS::parseGNSMode( char chr )
+{
+  if (chrCount == 0) {
+    NMEAGPS_INVALIDATE( status );
+    m_fix.status = gps_fix::STATUS_NONE;
+  }
+
+  if (chr == ',') {
+    m_fix.valid.status = (chrCount != 0);
+
+  } else {
+    gps_fix::status_t status = gps_fix::STATUS_NONE;
+
+    switch (chr) {
+      case 'A': status = gps_fix::STATUS_STD      ; break;
+      case 'D': status = gps_fix::STATUS_DGPS     ; break;
+      case 'E': status = gps_fix::STATUS_EST      ; break;
+      case 'F': status = gps_fix::STATUS_RTK_FLOAT; break;
+      case 'P': status = gps_fix::STATUS_PPS      ; break;
+      case 'R': status = gps_fix::STATUS_RTK_FIXED; break;
+      case 'M': // manual input
+      case 'N': // no fix
+      case 'S': // simulator
+        break;
+      default:
+        if (validateChars())
+          sentenceInvalid();
+        break;
+    }
+
+    if (m_fix.status < status)
+      m_fix.status = status;
+  }
+
+  return true;
+
+} // parseGNSMode
+
 //----------------------------------------------------------------
 
 bool NMEAGPS::parseFloat
@@ -1703,6 +2848,225 @@ bool NMEAGPS::parseEW( char chr )
 
 } // parseEW
 
+//----------------------------------------------------------------
+//  SWAR ("SIMD within a register") field parsing.  When a complete
+//    sentence is in memory, a whole field can be checked and
+//    converted with a few 64-bit operations, instead of calling
+//    /parseField/ for each character.  The first character of a
+//    field is in the lowest byte of a little-endian load.
+
+#ifdef NMEAGPS_SWAR_FIELDS
+
+static const uint64_t SWAR_ONES = 0x0101010101010101ULL;
+
+static inline uint64_t load8( const uint8_t *p )
+{
+  uint64_t w;
+  memcpy( &w, p, sizeof(w) );
+  return w;
+}
+
+//  A mask for the first /n/ characters (bytes) of a load.
+
+static inline uint64_t firstBytes( uint8_t n )
+{
+  return (n >= 8) ? ~0ULL : ((1ULL << (n*8)) - 1);
+}
+
+//  Convert ASCII digits to binary digits, 0..9 in each byte.
+
+static inline uint64_t digitValues( uint64_t w )
+{
+  return w ^ (SWAR_ONES * '0');
+}
+
+//  Bit 7 of each byte is set if that character is not a digit.
+
+static inline uint64_t nonDigits( uint64_t w )
+{
+  uint64_t d = digitValues( w );
+  return (((d & (SWAR_ONES * 0x7F)) + (SWAR_ONES * (0x80 - 10))) | d) &
+         (SWAR_ONES * 0x80);
+}
+
+//  Combine each pair of binary digits into 0..99, in bytes 0, 2, 4 and 6.
+
+static inline uint64_t digitPairs( uint64_t d )
+{
+  return (d * 10) + (d >> 8);
+}
+
+//  The value of 8 binary digits.  The first digit (lowest byte) is
+//    the most significant.
+
+static inline uint32_t eightDigits( uint64_t d )
+{
+  d = digitPairs( d );
+  d = (((d         & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+       (((d >> 16) & 0x000000FF000000FFULL) * (  1 + (  10000ULL << 32))))
+      >> 32;
+  return (uint32_t) d;
+}
+
+//  The value of the first /n/ (0..8) binary digits.
+
+static inline uint32_t firstDigits( uint64_t d, uint8_t n )
+{
+  return n ? eightDigits( d << ((8-n)*8) ) : 0;
+}
+
+//----------------------------------------------------------------
+
+bool NMEAGPS::parseSlice( const uint8_t *chars, uint8_t len, uint8_t avail )
+{
+  if ((len < 6) || (16 < len) || (avail < 16))
+    return false;
+
+  const schema_t *schema = schemaFor( nmeaMessage );
+  if (!schema)
+    return false;
+
+  uint64_t w       = load8( chars );
+  uint64_t bad     = nonDigits( w ) & firstBytes( len );
+  uint64_t lastBad = 0;
+  if (len > 8)
+    lastBad = nonDigits( load8( chars+8 ) ) & firstBytes( len-8 );
+
+  switch (schemaField( schema, fieldIndex )) {
+
+    #ifdef GPS_FIX_TIME
+      case FIELD_TIME:
+        {
+          //  hhmmss[.s[s...]].  Anything else at [6] is left to
+          //    /parseTime/, which only rejects it with validateChars.
+          if (len > 6) {
+            if (chars[6] != '.')
+              return false;
+            bad &= ~(0x80ULL << (6*8));
+          }
+          if (bad | lastBad)
+            return false;
+
+          uint64_t pairs   = digitPairs( digitValues( w ) );
+          uint8_t hours   = (uint8_t) pairs;
+          uint8_t minutes = (uint8_t) (pairs >> 16);
+          uint8_t seconds = (uint8_t) (pairs >> 32);
+          if (validateFields() &&
+              ((23 < hours) || (59 < minutes) || (59 < seconds)))
+            return false;
+
+          NMEAGPS_INVALIDATE( time );
+          m_fix.dateTime.hours   = hours;
+          m_fix.dateTime.minutes = minutes;
+          m_fix.dateTime.seconds = seconds;
+          m_fix.dateTime_cs      = 0;
+          if (len > 7)
+            m_fix.dateTime_cs    = (chars[7] - '0')*10;
+          if (len > 8)
+            m_fix.dateTime_cs   += (chars[8] - '0');
+          m_fix.valid.time = true;
+        }
+        return true;
+    #endif
+
+    #ifdef GPS_FIX_DATE
+      case FIELD_DDMMYY:
+        {
+          //  ddmmyy
+          if ((len != 6) || bad)
+            return false;
+
+          uint64_t pairs = digitPairs( digitValues( w ) );
+          uint8_t  date  = (uint8_t) pairs;
+          uint8_t  month = (uint8_t) (pairs >> 16);
+          if (validateFields()) {
+            uint8_t days =
+              pgm_read_byte( &NeoGPS::time_t::days_in[date] );
+            if ((date < 1) || (days < date) || (month < 1) || (12 < month))
+              return false;
+          }
+
+          NMEAGPS_INVALIDATE( date );
+          m_fix.dateTime.date  = date;
+          m_fix.dateTime.month = month;
+          m_fix.dateTime.year  = (uint8_t) (pairs >> 32);
+          m_fix.valid.date = true;
+        }
+        return true;
+    #endif
+
+    #if defined( GPS_FIX_LOCATION ) & !defined( GPS_FIX_LOCATION_DMS )
+      case FIELD_LAT:
+      case FIELD_LON:
+        {
+          //  [ddd]dmm[.mmmm...]
+          if (lastBad)
+            return false;
+          uint8_t intDigits = len;
+          if (bad) {
+            intDigits = __builtin_ctzll( bad ) / 8;
+            if ((chars[intDigits] != '.') ||
+                (bad & ~(0x80ULL << (intDigits*8))))
+              return false;
+          }
+          if ((intDigits < 1) || (5 < intDigits))
+            return false;
+
+          uint32_t whole = firstDigits( digitValues( w ), intDigits );
+          uint8_t  min   = whole % 100;
+          whole /= 100;
+          uint8_t  deg   = whole % 100;
+          if (whole >= 100)
+            deg += 100; // only possible if abs(longitude) >= 100.0 degrees
+          if (validateFields() && (min >= 60))
+            return false;
+
+          bool lat = (schemaField( schema, fieldIndex ) == FIELD_LAT);
+          if (!lat && !group_valid)
+            return false;
+
+          //  Up to 5 decimal digits of the minutes, and a 6th for rounding
+          uint8_t  decimals = (intDigits < len) ? len - intDigits - 1 : 0;
+          uint8_t  used     = (decimals < 5) ? decimals : 5;
+          uint64_t frac     = digitValues( load8( chars + intDigits + 1 ) );
+          int32_t  val      = ((deg * 60) + min) * 100000L +
+                              firstDigits( frac & firstBytes( used ), 5 );
+
+          // Convert minutes x 1000000 to degrees x 10000000.
+          val += divu3(val*2 + 1); // same as 10 * ((val+30)/60) without trunc
+          if (decimals > 5) {
+            char chr = chars[ intDigits + 6 ];
+            if (chr >= '9')
+              val += 2;
+            else if (chr >= '4')
+              val += 1;
+          }
+
+          if (validateFields() &&
+              (val > (lat ? 900000000L : 1800000000L)))
+            return false;
+
+          if (lat) {
+            group_valid = true;
+            NMEAGPS_INVALIDATE( location );
+            m_fix.location._lat = val;
+          } else
+            m_fix.location._lon = val;
+          decimal = 1 + decimals;
+        }
+        return true;
+    #endif
+
+    default:
+      break;
+  }
+
+  return false;
+
+} // parseSlice
+
+#endif
+
 //----------------------------------------------------------------
 
 bool NMEAGPS::parseSpeed( char chr )
@@ -1766,6 +3130,27 @@ bool NMEAGPS::parseHeading( char chr )
 
 //----------------------------------------------------------------
 
+bool NMEAGPS::parseTrueHeading( char chr )
+{
+  #ifdef GPS_FIX_TRUE_HEADING
+    if (chrCount == 0)
+      NMEAGPS_INVALIDATE( trueHeading );
+    if (parseFloat( m_fix.trueHdg, chr, 2 )) {
+
+      if (validateFields() && m_fix.valid.trueHeading &&
+          (negative || (m_fix.trueHdg.whole >= 360)))
+        sentenceInvalid();
+      else
+        m_fix.valid.trueHeading = (chrCount != 0);
+    }
+  #endif
+
+  return true;
+
+} // parseTrueHeading
+
+//----------------------------------------------------------------
+
 bool NMEAGPS::parseAlt(char chr )
 {
   #ifdef GPS_FIX_ALTITUDE
@@ -1818,6 +3203,37 @@ bool NMEAGPS::parseSatellites( char chr )
 
 } // parseSatellites
 
+//----------------------------------------------------------------
+//  A datum code has 3 characters (e.g., "W84" or "999").
+
+bool NMEAGPS::parseDatum( char chr )
+{
+  #ifdef GPS_FIX_DATUM
+    if (chrCount == 0) {
+      NMEAGPS_INVALIDATE( datum );
+      comma_needed( true );
+    }
+
+    const uint8_t MAX_CHARS = sizeof(m_fix.datum)-1;
+
+    if (chr == ',') {
+      if (chrCount < MAX_CHARS)
+        m_fix.datum[ chrCount ] = '\0';
+      m_fix.datum[ MAX_CHARS ] = '\0';
+      m_fix.valid.datum = (chrCount != 0);
+
+    } else if (chrCount < MAX_CHARS) {
+      m_fix.datum[ chrCount ] = chr;
+
+    } else if (validateFields()) {
+      sentenceInvalid();
+    }
+  #endif
+
+  return true;
+
+} // parseDatum
+
 //----------------------------------------------------------------
 
 bool NMEAGPS::parseHDOP( char chr )
@@ -1943,26 +3359,32 @@ const gps_fix NMEAGPS::read()
 {
   gps_fix fix;
 
-  if (_fixesAvailable) {
-    lock();
+  #if (NMEAGPS_FIX_MAX > 0)
 
-      #if (NMEAGPS_FIX_MAX > 0)
-        _fixesAvailable--;
-        fix = buffer[ _firstFix ];
-        if (merging == EXPLICIT_MERGING)
-          // Prepare to accumulate all fixes in an interval
-          buffer[ _firstFix ].init();
-        if (++_firstFix >= NMEAGPS_FIX_MAX)
-          _firstFix = 0;
-      #else
+    const gps_fix *next;
+    while ((next = peek()) != NULL) {
+      fix = *next;
+      if (commit())
+        return fix;
+    }
+    fix.init(); // all the copies were dropped
+
+  #else
+
+    if (_fixesAvailable) {
+      lock();
         if (is_safe()) {
           _fixesAvailable = false;
           fix = m_fix;
+          #ifdef NMEAGPS_TRACE_LATENCY
+            trace      = _fixTrace;
+            trace.read = micros();
+          #endif
         }
-      #endif
+      unlock();
+    }
 
-    unlock();
-  }
+  #endif
 
   return fix;
 
@@ -1970,6 +3392,74 @@ const gps_fix NMEAGPS::read()
 
 //----------------------------------------------------------------
 
+const gps_fix *NMEAGPS::peek()
+{
+  #if (NMEAGPS_FIX_MAX > 0)
+
+    uint8_t tail = loadIndex( _fixTail );
+    if (loadIndex( _fixHead ) == tail)
+      return (const gps_fix *) NULL;
+
+    _peekTail = tail;
+    #ifdef NMEAGPS_TRACE_LATENCY
+      trace      = _fixTraces[ tail & FIX_MASK ];
+      trace.read = micros();
+    #endif
+    return &buffer[ tail & FIX_MASK ];
+
+  #else
+
+    // Lend the fix being parsed, if it is complete.
+    if (_fixesAvailable && is_safe()) {
+      #ifdef NMEAGPS_TRACE_LATENCY
+        trace      = _fixTrace;
+        trace.read = micros();
+      #endif
+      return &m_fix;
+    }
+    return (const gps_fix *) NULL;
+
+  #endif
+
+} // peek
+
+//----------------------------------------------------------------
+
+bool NMEAGPS::commit()
+{
+  #if (NMEAGPS_FIX_MAX > 0)
+
+    uint8_t tail = _peekTail;
+
+    #ifdef NEOGPS_ATOMIC_INDICES
+      return __atomic_compare_exchange_n( &_fixTail, &tail, (uint8_t) (tail+1),
+                                          false, __ATOMIC_RELEASE, __ATOMIC_RELAXED );
+    #else
+      // Keep the ISR from dropping this fix while it is released.
+      lock();
+        bool ok = (_fixTail == tail);
+        if (ok)
+          storeIndex( _fixTail, tail+1 );
+      unlock();
+      return ok;
+    #endif
+
+  #else
+
+    // If a new sentence has started, the fix was not stable.
+    lock();
+      bool ok = is_safe();
+      if (ok)
+        _fixesAvailable = false;
+    unlock();
+    return ok;
+
+  #endif
+
+} // commit
+
+//----------------------------------------------------------------
+
 void NMEAGPS::poll( Stream *device, nmea_msg_t msg )
 {
   //  Only the ublox documentation references talker ID "EI".
@@ -1977,12 +3467,24 @@ void NMEAGPS::poll( Stream *device, nmea_msg_t msg )
   //  However, "GP" is reserved for the GPS device, so it seems inconsistent
   //  to use that talker ID when requesting something from the GPS device.
 
+  #if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+    static const char dtm[] __PROGMEM = "EIGPQ,DTM";
+  #endif
+  #if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+    static const char gbs[] __PROGMEM = "EIGPQ,GBS";
+  #endif
   #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
     static const char gga[] __PROGMEM = "EIGPQ,GGA";
   #endif
   #if defined(NMEAGPS_PARSE_GLL) | defined(NMEAGPS_RECOGNIZE_ALL)
     static const char gll[] __PROGMEM = "EIGPQ,GLL";
   #endif
+  #if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+    static const char gns[] __PROGMEM = "EIGPQ,GNS";
+  #endif
+  #if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+    static const char grs[] __PROGMEM = "EIGPQ,GRS";
+  #endif
   #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
     static const char gsa[] __PROGMEM = "EIGPQ,GSA";
   #endif
@@ -1992,6 +3494,9 @@ void NMEAGPS::poll( Stream *device, nmea_msg_t msg )
   #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_RECOGNIZE_ALL)
     static const char gsv[] __PROGMEM = "EIGPQ,GSV";
   #endif
+  #if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+    static const char hdt[] __PROGMEM = "EIGPQ,HDT";
+  #endif
   #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
     static const char rmc[] __PROGMEM = "EIGPQ,RMC";
   #endif
@@ -2004,12 +3509,24 @@ void NMEAGPS::poll( Stream *device, nmea_msg_t msg )
 
   static const char * const poll_msgs[] __PROGMEM =
     {
+      #if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+        dtm,
+      #endif
+      #if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+        gbs,
+      #endif
       #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
         gga,
       #endif
       #if defined(NMEAGPS_PARSE_GLL) | defined(NMEAGPS_RECOGNIZE_ALL)
         gll,
       #endif
+      #if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+        gns,
+      #endif
+      #if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+        grs,
+      #endif
       #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
         gsa,
       #endif
@@ -2019,6 +3536,9 @@ void NMEAGPS::poll( Stream *device, nmea_msg_t msg )
       #if defined(NMEAGPS_PARSE_GSV) | defined(NMEAGPS_RECOGNIZE_ALL)
         gsv,
       #endif
+      #if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+        hdt,
+      #endif
       #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
         rmc,
       #endif
@@ -27,6 +27,40 @@
 
 #include "GPSfix.h"
 #include "NMEAGPS_cfg.h"
+#include "SatelliteTable.h"
+
+namespace NeoGPS {
+  class NMEAframe;
+};
+
+#ifdef NMEAGPS_LAZY_FIX
+  class lazy_fix;
+#endif
+
+//------------------------------------------------------
+//  The bit for one sentence type in a sentence mask (see
+//    NMEAGPS::profile_t and BasicNMEAGPS), and the bit for one
+//    field converter (NMEAGPS::field_t) in a converter mask.
+
+#define NMEAGPS_SENTENCE(msg) (1UL << (msg))
+#define NMEAGPS_CONVERTER(f)  (1UL << (f))
+
+//  A profile or a BasicNMEAGPS can parse fewer fields of a sentence
+//    than its schema.  The fields of the current sentence are
+//    remembered, so that the others are skipped.
+
+#if defined(NMEAGPS_RUNTIME_PROFILE) | defined(NMEAGPS_BASIC_PARSER)
+  #define NMEAGPS_FIELD_MASKS
+#endif
+
+//  The hooks that BasicNMEAGPS overrides are virtual even without
+//    NMEAGPS_DERIVED_TYPES.
+
+#if defined(NMEAGPS_DERIVED_TYPES) | defined(NMEAGPS_BASIC_PARSER)
+  #define NMEAGPS_CONFIG_VIRTUAL virtual
+#else
+  #define NMEAGPS_CONFIG_VIRTUAL
+#endif
 
 //------------------------------------------------------
 //
@@ -51,12 +85,25 @@ public:
 
     NMEAGPS();
 
+    #if defined(NMEAGPS_DERIVED_TYPES) | defined(NMEAGPS_BASIC_PARSER)
+      // Derived parsers may be deleted through an NMEAGPS pointer.
+      virtual ~NMEAGPS() {};
+    #endif
+
     //.......................................................................
     // NMEA standard message types (aka "sentences")
 
     enum nmea_msg_t {
         NMEA_UNKNOWN,
 
+        #if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+          NMEA_DTM,
+        #endif
+
+        #if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+          NMEA_GBS,
+        #endif
+
         #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
           NMEA_GGA,
         #endif
@@ -65,6 +112,14 @@ public:
           NMEA_GLL,
         #endif
 
+        #if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+          NMEA_GNS,
+        #endif
+
+        #if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+          NMEA_GRS,
+        #endif
+
         #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
           NMEA_GSA,
         #endif
@@ -77,6 +132,10 @@ public:
           NMEA_GSV,
         #endif
 
+        #if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+          NMEA_HDT,
+        #endif
+
         #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
           NMEA_RMC,
         #endif
@@ -127,6 +186,28 @@ public:
 
     const gps_fix read();
 
+    //.......................................................................
+    //  Examine the next available fix in place, without copying it.
+    //    Returns NULL if no fixes are available.  The fix stays in the
+    //    buffer until commit is called.
+    //
+    //    The fix buffer is a single-producer, single-consumer ring.
+    //    The parser may run in a different thread (or an ISR), but
+    //    only one thread should call read, peek and commit.
+    //
+    //    If NMEAGPS_FIX_MAX is 0, this is the fix being parsed, so it
+    //    only stays the same until the next character is handled.
+
+    const gps_fix *peek();
+
+    //  Remove (release) the fix returned by peek.  Returns false if the
+    //    parser dropped that fix (see NMEAGPS_KEEP_NEWEST_FIXES), or
+    //    started a new sentence (if NMEAGPS_FIX_MAX is 0), while it was
+    //    being examined.  The fix may have been partially overwritten,
+    //    so it should be discarded.
+
+    bool commit();
+
     //.......................................................................
     //  The OVERRUN flag is set whenever a fix is not read by the time
     //  the next update interval starts.  You must clear it when you
@@ -149,6 +230,55 @@ public:
 
     decode_t handle( uint8_t c );
 
+    //.......................................................................
+    //  Process a block of characters, possibly saving buffered fixes.
+    //    This is useful when the characters are already in memory
+    //    (e.g., a DMA buffer, a log file, or a large serial read).
+    //
+    //    If a /handler/ is given, each fix is "read" and passed to the
+    //    /handler/ as soon as it is available, along with the /context/.
+    //    All the characters are consumed.
+    //
+    //    If no /handler/ is given, processing stops when the fix buffer
+    //    is full, so that no fixes are dropped.  Call read() to empty
+    //    the fix buffer, then call handle again with the remaining
+    //    characters.
+    //
+    //    Complete sentences are checked before they are parsed.  A
+    //    sentence with a bad checksum is skipped without affecting the
+    //    current fix, and it is counted in statistics.errors, even if
+    //    it is not a recognized type.  In a good sentence, only the
+    //    fields for the members enabled in GPSfix_cfg.h are parsed.
+    //
+    //    Returns the number of characters consumed.
+
+    typedef void (*fix_handler_t)( const gps_fix & fix, void *context );
+
+    size_t handle( const uint8_t *buf, size_t len,
+                   fix_handler_t handler = (fix_handler_t) NULL,
+                   void *context = NULL );
+
+    #ifdef NMEAGPS_LAZY_FIX
+      //.......................................................................
+      //  Process a block of characters, but only convert the fields
+      //    that the /handler/ uses (see LazyFix.h).  The /handler/ is
+      //    called with the /lazy/ fix when each update interval is
+      //    complete (or after each sentence, for NO_MERGING).  The fix
+      //    buffer is not used.
+      //
+      //    A sentence that is not complete at the end of the block is
+      //    not consumed.  Pass it again, with the characters that
+      //    follow it.
+      //
+      //    Returns the number of characters consumed.
+
+      typedef void (*lazy_handler_t)( lazy_fix & fix, void *context );
+
+      size_t handle( const uint8_t *buf, size_t len,
+                     lazy_fix & lazy, lazy_handler_t handler,
+                     void *context = NULL );
+    #endif
+
     //=======================================================================
     // CHARACTER-ORIENTED methods: decode, fix and is_safe
     //=======================================================================
@@ -225,15 +355,111 @@ public:
     //  Various parsing statistics
 
     #ifdef NMEAGPS_STATS
+      #ifdef NMEAGPS_EXTENDED_STATS
+        //  Counts for one sentence type
+        struct msg_statistics_t {
+            uint32_t ok;
+            uint32_t errors; // checksum errors
+        };
+
+        //  Update interval timing, from the first character of an
+        //    interval until its fix is stored.  Bucket 0 counts the
+        //    intervals shorter than 1024us, and bucket i counts the
+        //    intervals from 1024us * 2^(i-1) up to 1024us * 2^i.
+        //    The last bucket also counts all the longer intervals.
+        struct interval_statistics_t {
+            CONST_CLASS_DATA uint8_t BUCKETS = 12;
+
+            uint32_t count;
+            uint32_t min_us;
+            uint32_t max_us;
+            uint32_t histogram[ BUCKETS ];
+
+            void init()
+              {
+                count  = 0L;
+                min_us = 0xFFFFFFFFUL;
+                max_us = 0L;
+                for (uint8_t i=0; i < BUCKETS; i++)
+                  histogram[i] = 0L;
+              }
+            void add( uint32_t us )
+              {
+                count++;
+                if (min_us > us)
+                  min_us = us;
+                if (max_us < us)
+                  max_us = us;
+                uint8_t  bucket = 0;
+                uint32_t t      = us >> 10;
+                while (t && (bucket < BUCKETS-1)) {
+                  t >>= 1;
+                  bucket++;
+                }
+                histogram[ bucket ]++;
+              }
+            interval_statistics_t & operator +=( const interval_statistics_t & r )
+              {
+                count += r.count;
+                if (min_us > r.min_us)
+                  min_us = r.min_us;
+                if (max_us < r.max_us)
+                  max_us = r.max_us;
+                for (uint8_t i=0; i < BUCKETS; i++)
+                  histogram[i] += r.histogram[i];
+                return *this;
+              }
+        };
+      #endif
+
       struct statistics_t {
           uint32_t ok;     // count of successfully parsed sentences
           uint32_t errors; // NMEA checksum or other message errors
           uint32_t chars;
+
+          #ifdef NMEAGPS_EXTENDED_STATS
+            // Indexed by nmea_msg_t
+            msg_statistics_t      messages[ NMEAGPS_STATS_MSGS ];
+            uint32_t              unrecognized; // well-formed, unknown type
+            uint32_t              discarded;    // chars between sentences (not CR/LF)
+            interval_statistics_t interval;
+
+            msg_statistics_t & message( nmea_msg_t msg )
+              { return messages[ (msg < NMEAGPS_STATS_MSGS) ? msg : NMEA_UNKNOWN ]; }
+            const msg_statistics_t & message( nmea_msg_t msg ) const
+              { return messages[ (msg < NMEAGPS_STATS_MSGS) ? msg : NMEA_UNKNOWN ]; }
+          #endif
+
           void init()
             {
               ok     = 0L;
               errors = 0L;
               chars  = 0L;
+              #ifdef NMEAGPS_EXTENDED_STATS
+                for (uint8_t i=0; i < NMEAGPS_STATS_MSGS; i++) {
+                  messages[i].ok     = 0L;
+                  messages[i].errors = 0L;
+                }
+                unrecognized = 0L;
+                discarded    = 0L;
+                interval.init();
+              #endif
+            }
+          statistics_t & operator +=( const statistics_t & r )
+            {
+              ok     += r.ok;
+              errors += r.errors;
+              chars  += r.chars;
+              #ifdef NMEAGPS_EXTENDED_STATS
+                for (uint8_t i=0; i < NMEAGPS_STATS_MSGS; i++) {
+                  messages[i].ok     += r.messages[i].ok;
+                  messages[i].errors += r.messages[i].errors;
+                }
+                unrecognized += r.unrecognized;
+                discarded    += r.discarded;
+                interval     += r.interval;
+              #endif
+              return *this;
             }
       } statistics;
     #endif
@@ -242,19 +468,29 @@ public:
     // SATELLITE VIEW array
 
     #ifdef NMEAGPS_PARSE_SATELLITES
-      struct satellite_view_t
-      {
-        uint8_t    id;
-        #ifdef NMEAGPS_PARSE_SATELLITE_INFO
-          uint8_t  elevation; // 0..99 deg
-          uint16_t azimuth;   // 0..359 deg
-          uint8_t  snr     NEOGPS_BF(7); // 0..99 dBHz
-          bool     tracked NEOGPS_BF(1);
-        #endif
-      } NEOGPS_PACKED;
-
-      satellite_view_t satellites[ NMEAGPS_MAX_SATELLITES ];
-      uint8_t          sat_count; // in the above array
+      #ifdef NMEAGPS_SATELLITE_TABLE
+        //  satellites[i] returns an entry by value, with the same members
+        //    as below, plus /system/, /signal/, /used/ and /age/.
+        typedef NeoGPS::SatelliteTable_t::satellite_t satellite_view_t;
+
+        NeoGPS::SatelliteTable_t satellites;
+        uint8_t                  sat_count; // same as satellites.count
+
+      #else
+        struct satellite_view_t
+        {
+          uint8_t    id;
+          #ifdef NMEAGPS_PARSE_SATELLITE_INFO
+            uint8_t  elevation; // 0..99 deg
+            uint16_t azimuth;   // 0..359 deg
+            uint8_t  snr     NEOGPS_BF(7); // 0..99 dBHz
+            bool     tracked NEOGPS_BF(1);
+          #endif
+        } NEOGPS_PACKED;
+
+        satellite_view_t satellites[ NMEAGPS_MAX_SATELLITES ];
+        uint8_t          sat_count; // in the above array
+      #endif
 
       bool satellites_valid() const { return (sat_count >= m_fix.satellites); }
     #endif
@@ -317,6 +553,29 @@ public:
         // }
     #endif
 
+    //=======================================================================
+    // TRACING FIX LATENCY
+    //=======================================================================
+
+    #ifdef NMEAGPS_TRACE_LATENCY
+      //  The micros() values for one fix, from the first character of its
+      //    update interval until the application received it.  The bulk
+      //    handle( buf, len ) timestamps each sentence when it is parsed,
+      //    not when its characters arrived.
+      struct fix_trace_t
+      {
+        uint32_t firstChar;    // the '$' (or UBX sync) that ended the quiet time
+        uint32_t lastSentence; // the last sentence of the interval was complete
+        uint32_t stored;       // the fix was put in the fix buffer
+        uint32_t read;         // the fix was taken by read or peek (or handler)
+
+        void init() { firstChar = lastSentence = stored = read = 0; };
+      };
+
+      //  The timestamps of the fix most recently returned by read or peek.
+      fix_trace_t trace;
+    #endif
+
     //=======================================================================
     // COMMUNICATING WITH THE GPS DEVICE: poll, send and send_P
     //=======================================================================
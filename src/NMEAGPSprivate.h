@@ -22,7 +22,8 @@
     // in derived classes by adding a second table.  Additional tables
     // can be singly-linked through the /previous/ member.  The instantiated
     // class's table is the head, and should be returned by the derived
-    // /msg_table/ function.  Tables should be sorted alphabetically.
+    // /msg_table/ function.  Each sentence type string must have 1 to 3
+    // characters, either digits or upper-case letters.
 
     struct msg_table_t {
       uint8_t             offset;  // nmea_msg_t enum starting value
@@ -64,6 +65,9 @@
 
       #ifdef NMEAGPS_PARSE_SATELLITES
         sat_count = 0;
+        #ifdef NMEAGPS_SATELLITE_TABLE
+          satellites.init();
+        #endif
       #endif
     }
 
@@ -79,9 +83,86 @@
 
     static const bool keepNewestFixes = NMEAGPS_KEEP_NEWEST_FIXES;
 
+    //.......................................................................
+    //  The field converters of the standard sentence schemas (see
+    //    /schema_t/).  NMEAGPS_CONVERTER( NMEAGPS::FIELD_ALT ) is the
+    //    mask bit for one of them.
+
+    enum field_t {
+      FIELD_SKIP,
+      FIELD_TIME,
+      FIELD_DDMMYY,
+      FIELD_FIX,
+      FIELD_LAT,
+      FIELD_NS,
+      FIELD_LON,
+      FIELD_EW,
+      FIELD_SPEED,
+      FIELD_SPEED_KPH,
+      FIELD_HEADING,
+      FIELD_ALT,
+      FIELD_GEOID_HEIGHT,
+      FIELD_SATELLITES,
+      FIELD_HDOP,
+      FIELD_VDOP,
+      FIELD_PDOP,
+      FIELD_LAT_ERR,
+      FIELD_LON_ERR,
+      FIELD_ALT_ERR,
+      FIELD_ZDA_DATE,
+      FIELD_GNS_MODE,
+      FIELD_TRUE_HEADING,
+      FIELD_DATUM,
+
+      FIELD_DERIVED // first converter of a derived class
+    };
+
     static const bool validateChars () { return NMEAGPS_VALIDATE_CHARS; }
     static const bool validateFields() { return NMEAGPS_VALIDATE_FIELDS; }
 
+    #ifdef NMEAGPS_RUNTIME_PROFILE
+      //.......................................................................
+      //  What this instance parses (see NMEAGPS_cfg.h).  Sentences and
+      //    members that are not configured can not be parsed, even if
+      //    they are selected here.
+      //
+      //    NMEAGPS::profile_t ggaRmc;
+      //    ggaRmc.init();
+      //    ggaRmc.sentences = NMEAGPS_SENTENCE( NMEAGPS::NMEA_GGA ) |
+      //                       NMEAGPS_SENTENCE( NMEAGPS::NMEA_RMC );
+      //    ggaRmc.members.altitude = false;
+      //    gps.profile( ggaRmc );
+
+      struct profile_t
+      {
+        uint32_t         sentences;    // NMEAGPS_SENTENCE bits
+        gps_fix::valid_t members;      // the fix members that are parsed
+        nmea_msg_t       lastSentence NEOGPS_BF(8); // ends each interval
+        merging_t        merging      NEOGPS_BF(8);
+
+        //  Everything in the configuration files
+        void init()
+          {
+            sentences    = 0xFFFFFFFFUL;
+            lastSentence = LAST_SENTENCE_IN_INTERVAL;
+            merging      = NMEAGPS_MERGING;
+
+            uint8_t *all = (uint8_t *) &members;
+            for (uint8_t i=0; i<sizeof(members); i++)
+              *all++ = 0xFF;
+          }
+      };
+
+      //  Use a different profile.  Returns false if the /merging/ is not
+      //    possible: IMPLICIT_MERGING must be configured in NMEAGPS_cfg.h
+      //    to be used, and it is the only choice when it is configured.
+      //    EXPLICIT_MERGING needs NMEAGPS_FIX_MAX > 0.  This should be
+      //    called between sentences (e.g., when is_safe() is true).
+
+      bool profile( const profile_t & p );
+      const profile_t & profile() const { return _profile; };
+    #endif
+
     //.......................................................................
     //  Control access to this object.  This preserves atomicity when
     //     the processing style is interrupt-driven.
@@ -106,11 +187,42 @@
     //  Current fix
     gps_fix m_fix;
 
+    #ifdef NMEAGPS_SHADOW_FIX
+      //  The current fix before this sentence changed it
+      gps_fix m_shadow;
+    #endif
+
+    //  Save the current fix before a sentence changes it, or discard
+    //    the changes of a rejected sentence.  Without a shadow copy,
+    //    all the values are suspect, and the fix is cleared.
+
+    void shadowFix()
+      {
+        #ifdef NMEAGPS_SHADOW_FIX
+          m_shadow = m_fix;
+        #endif
+      }
+
+    void rejectFix()
+      {
+        #ifdef NMEAGPS_SHADOW_FIX
+          m_fix = m_shadow;
+        #else
+          m_fix.valid.init();
+        #endif
+      }
+
     // Current parser state
     uint8_t      crc;            // accumulated CRC in the sentence
-    uint8_t      fieldIndex;     // index of current field in the sentence
     uint8_t      chrCount;       // index of current character in current field
-    uint8_t      decimal;        // digits received after the decimal point
+    union {
+      uint16_t   cmdKey;         // sentence type, while receiving the header
+      struct {
+        uint8_t  fieldIndex;     // index of current field in the sentence
+        uint8_t  decimal;        // digits received after the decimal point
+      };
+    };
+    uint8_t      _converter;     // field_t of the current field (see /fieldBegins/)
     struct {
       bool     negative          NEOGPS_BF(1); // field had a leading '-'
       bool     _comma_needed     NEOGPS_BF(1); // field needs a comma to finish parsing
@@ -119,12 +231,77 @@
       bool     _intervalComplete NEOGPS_BF(1); // automatically set after LAST received
       #if (NMEAGPS_FIX_MAX == 0)
         bool   _fixesAvailable   NEOGPS_BF(1);
+      #else
+        bool   _fixStarted       NEOGPS_BF(1); // buffer[ _fixHead ] was initialized
       #endif
       #ifdef NMEAGPS_PARSE_PROPRIETARY
         bool   proprietary       NEOGPS_BF(1); // receiving proprietary message
       #endif
+      #ifdef NMEAGPS_EXTENDED_STATS
+        bool   _intervalTimed    NEOGPS_BF(1); // _statsIntervalStart is valid
+      #endif
+      #ifdef NMEAGPS_SATELLITE_TABLE
+        bool   _parsed           NEOGPS_BF(1); // sentence fields are being parsed
+      #endif
     } NEOGPS_PACKED;
 
+    #ifdef NMEAGPS_EXTENDED_STATS
+      //  Start timing an update interval.  Derived classes that
+      //    override the start of a sentence must call this when the
+      //    quiet time ends, just like sentenceBegin.
+      uint32_t _statsIntervalStart; // micros() when the interval started
+
+      void statsIntervalBegin()
+        {
+          _statsIntervalStart = micros();
+          _intervalTimed      = true;
+        }
+    #endif
+
+    #ifdef NMEAGPS_TRACE_LATENCY
+      //  Timestamp the first character of a fix.  Derived classes that
+      //    override the start of a sentence must call this, too.
+      uint32_t _traceFirstChar;
+
+      void traceBegin()
+        {
+          if (intervalComplete() || (currentMerging() == NO_MERGING))
+            _traceFirstChar = micros();
+        }
+
+      //  The timestamps of each buffered fix.
+      #if (NMEAGPS_FIX_MAX > 0)
+        fix_trace_t _fixTraces[ NMEAGPS_FIX_MAX ];
+      #else
+        fix_trace_t _fixTrace;
+      #endif
+    #endif
+
+    #ifdef NMEAGPS_SATELLITE_TABLE
+      //  The system implied by the talker ID of the current sentence.
+      uint8_t _talkerSystem;
+
+      //  The satellites of one GSV or GSA sentence are collected here.
+      //    They are added to the satellite table when the sentence is
+      //    complete and the CRC is good.
+      union {
+        struct {
+          uint8_t  id       [5]; // [4] is the NMEA 4.10 signal ID
+          uint8_t  elevation[4];
+          uint16_t azimuth  [4];
+          uint8_t  snr      [4];
+          uint8_t  tracked;      // one bit per satellite
+        } _gsv;
+
+        struct {
+          uint8_t  id[12];
+          uint8_t  systemID;     // NMEA 4.10
+        } _gsa;
+      };
+
+      void satellitesOk();
+    #endif
+
     #ifdef NMEAGPS_PARSING_SCRATCHPAD
       union {
         uint32_t U4;
@@ -154,25 +331,67 @@
         NMEA_IDLE,             // Waiting for initial '$'
         NMEA_RECEIVING_HEADER, // Parsing sentence type field
         NMEA_RECEIVING_DATA,   // Parsing fields up to the terminating '*'
-        NMEA_RECEIVING_CRC     // Receiving two-byte transmitted CRC
+        NMEA_RECEIVING_CRC,    // Receiving two-byte transmitted CRC
+        NMEA_SKIPPING_DATA     // Just checksum the fields that are not parsed
     };
     CONST_CLASS_DATA uint8_t NMEA_FIRST_STATE = NMEA_IDLE;
-    CONST_CLASS_DATA uint8_t NMEA_LAST_STATE  = NMEA_RECEIVING_CRC;
+    CONST_CLASS_DATA uint8_t NMEA_LAST_STATE  = NMEA_SKIPPING_DATA;
 
     rxState_t rxState NEOGPS_BF(8);
 
     //.......................................................................
+    //  Buffered fixes.  This is a single-producer, single-consumer ring.
+    //    The parser is the only writer of _fixHead: it accumulates the
+    //    next fix in buffer[ _fixHead & FIX_MASK ], and then publishes it
+    //    by incrementing _fixHead.  The reader (read, peek and commit)
+    //    normally advances _fixTail.  Both indices are free-running, so
+    //    the number of available fixes is their difference.
+    //
+    //    When the ring is full and keepNewestFixes is true, the parser
+    //    drops the oldest fix by advancing _fixTail.  The reader detects
+    //    this in commit, because _fixTail is no longer _peekTail.
 
-    uint8_t _available() const volatile { return _fixesAvailable; };
+    #if (NMEAGPS_FIX_MAX > 0)
 
-    //.......................................................................
-    //  Buffered fixes.
+      #if (NMEAGPS_FIX_MAX > 128) | \
+          ((NMEAGPS_FIX_MAX & (NMEAGPS_FIX_MAX-1)) != 0)
+        #error NMEAGPS_FIX_MAX must be a power of 2, from 1 to 128 (see NMEAGPS_cfg.h)
+      #endif
+      CONST_CLASS_DATA uint8_t FIX_MASK = NMEAGPS_FIX_MAX-1;
+
+      gps_fix buffer[ NMEAGPS_FIX_MAX ];
+      uint8_t _fixHead;   // written only by the parser
+      uint8_t _fixTail;   // written by the reader, or by the parser to drop a fix
+      uint8_t _peekTail;  // the reader's _fixTail when peek was called
+
+      uint8_t _available() const volatile
+        { return (uint8_t) (loadIndex( _fixHead ) - loadIndex( _fixTail )); };
+
+      //  Acquire/release access to the ring indices.
+
+      static uint8_t loadIndex( const volatile uint8_t & index )
+        {
+          #ifdef NEOGPS_ATOMIC_INDICES
+            return __atomic_load_n( &index, __ATOMIC_ACQUIRE );
+          #else
+            uint8_t value = index;
+            __asm__ __volatile__ ( "" ::: "memory" );
+            return value;
+          #endif
+        }
 
-    #if (NMEAGPS_FIX_MAX > 0)
-      gps_fix buffer[ NMEAGPS_FIX_MAX ]; // could be empty, see NMEAGPS_cfg.h
-      uint8_t _fixesAvailable;
-      uint8_t _firstFix;
-      uint8_t _currentFix;
+      static void storeIndex( volatile uint8_t & index, uint8_t value )
+        {
+          #ifdef NEOGPS_ATOMIC_INDICES
+            __atomic_store_n( &index, value, __ATOMIC_RELEASE );
+          #else
+            __asm__ __volatile__ ( "" ::: "memory" );
+            index = value;
+          #endif
+        }
+
+    #else
+      uint8_t _available() const volatile { return _fixesAvailable; };
     #endif
 
     //.......................................................................
@@ -188,9 +407,26 @@
     //  looks at the nmeaMessage member.  Derived classes may have
     //  more complex, specific conditions.
 
-    NMEAGPS_VIRTUAL bool intervalCompleted() const
-      { return (nmeaMessage == LAST_SENTENCE_IN_INTERVAL); }
-                               // see NMEAGPS_cfg.h
+    NMEAGPS_CONFIG_VIRTUAL bool intervalCompleted() const
+      {
+        #ifdef NMEAGPS_RUNTIME_PROFILE
+          return (nmeaMessage == _profile.lastSentence);
+        #else
+          return (nmeaMessage == LAST_SENTENCE_IN_INTERVAL);
+        #endif                     // see NMEAGPS_cfg.h
+      }
+
+    //  The merging technique that is used: the configured /merging/,
+    //    or the profile's.
+
+    merging_t currentMerging() const
+      {
+        #ifdef NMEAGPS_RUNTIME_PROFILE
+          return _profile.merging;
+        #else
+          return merging;
+        #endif
+      }
 
     //.......................................................................
     //  When a fix has been fully assembled from a batch of sentences, as
@@ -200,6 +436,11 @@
 
     void storeFix();
 
+    //  The satellite table and the interval statistics are updated
+    //    when an interval is complete, even if the fix is not stored.
+
+    void endInterval();
+
     //=======================================================================
     //   PARSING METHODS
     //=======================================================================
@@ -208,7 +449,15 @@
     // Try to recognize an NMEA sentence type, after the IDs have been accepted.
 
     decode_t parseCommand( char c );
-    decode_t parseCommand( const msg_table_t *msgs, uint8_t cmdCount, char c );
+
+    //.......................................................................
+    // The sentence type characters are packed into a base-37 key:
+    //   '0'..'9' are 1..10, and 'A'..'Z' are 11..36.  When the header
+    //   is complete, the key is looked up in each message table.
+
+    CONST_CLASS_DATA uint16_t MAX_KEY2 = 36*37 + 36; // largest 2-char key
+
+    nmea_msg_t findCommand( uint16_t key ) const;
 
     //.......................................................................
     // Parse various NMEA sentences
@@ -227,10 +476,113 @@
 
     NMEAGPS_VIRTUAL bool parseField( char chr );
 
+    //.......................................................................
+    // Return a mask of the fields in the current sentence type that have
+    //   something to parse.  Bit N is set if field N must be passed to
+    //   /parseField/.  The other fields are skipped by /decodeSentence/.
+    //   If no bits are set, /decode/ skips the whole sentence without
+    //   calling /parseField/.  Derived classes that parse more fields
+    //   of a standard sentence must override this.
+
+    NMEAGPS_CONFIG_VIRTUAL uint32_t parsedFields() const;
+
+    //  The /parsedFields/ of a standard sentence that use one of the
+    //    /converters/ (NMEAGPS_CONVERTER bits).  The satellite fields
+    //    of GSA and GSV, and the fields of derived sentences, are
+    //    always included.
+
+    uint32_t standardFields( uint32_t converters ) const;
+
+    #ifdef NMEAGPS_RUNTIME_PROFILE
+      profile_t _profile;
+      uint32_t  _converters; // the field_t bits for _profile.members
+    #endif
+
+    #ifdef NMEAGPS_FIELD_MASKS
+      uint32_t  _fields;     // the fields of this sentence that are parsed.
+                             //   Bit 31 is used for the later fields, too.
+
+      bool fieldParsed( uint8_t i ) const
+        { return (_fields >> ((i < 31) ? i : 31)) & 1; }
+    #endif
+
+    //  True if none of the fields after the current one are parsed.
+    //    This is checked in the NMEA_SKIPPING_DATA state.
+
+    bool skippingRest() const
+      {
+        #ifdef NMEAGPS_FIELD_MASKS
+          return (fieldIndex >= 31) ? !(_fields >> 31)
+                                    : !(_fields >> (fieldIndex+1));
+        #else
+          return true; // only sentences with nothing to parse are skipped
+        #endif
+      }
+
+    //  The /parsedFields/ of the current sentence, after the profile
+    //    is applied.  Only valid after the sentence type is received.
+
+    uint32_t sentenceFields() const
+      {
+        #ifdef NMEAGPS_FIELD_MASKS
+          return _fields;
+        #else
+          return parsedFields();
+        #endif
+      }
+
+    //.......................................................................
+    // Parse a complete sentence that has already been checked by
+    //   NMEAframe.  The '$' and the sentence type are passed to
+    //   /decode/, and then only the /parsedFields/ are parsed.
+
+    decode_t decodeSentence
+      ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame );
+
+    //  The two halves of /decodeSentence/.  If the sentence is not
+    //    accepted by /decodeHeader/ (rxState is not RECEIVING_DATA),
+    //    the rest of it has already been passed to /decode/, or it was
+    //    skipped because there was nothing to parse.
+
+    decode_t decodeHeader
+      ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame );
+    decode_t decodeFields
+      ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame );
+
+    //  Leave the FSM as if the CRC chars of the frame had been received.
+    void frameOk( const NeoGPS::NMEAframe & frame );
+
+    #ifdef NMEAGPS_LAZY_FIX
+      friend class lazy_fix;
+
+      //  Convert one part of a lazy_fix from the sentences that have
+      //    not been converted for that part yet.
+      void convertLazy( lazy_fix & lazy, uint8_t part );
+    #endif
+
+    #ifdef NMEAGPS_SWAR_FIELDS
+      //  Parse a complete time, date, latitude or longitude field of a
+      //    standard sentence, 8 characters at a time.  /avail/ is the
+      //    number of characters that can be read from /chars/.  Returns
+      //    false if the field must be passed to /parseField/ instead.
+      //    The results are identical to /parseField/, but a derived
+      //    /parseField/ does not see these characters.
+
+      bool parseSlice( const uint8_t *chars, uint8_t len, uint8_t avail );
+    #endif
+
+    #ifdef NMEAGPS_EXTENDED_STATS
+      //  The type of a standard sentence that NMEAframe rejected, without
+      //    passing it to /decode/.  Proprietary sentences are NMEA_UNKNOWN.
+      nmea_msg_t frameMessage
+        ( const uint8_t *sentence, const NeoGPS::NMEAframe & frame ) const;
+    #endif
+
     //.......................................................................
     // Parse the primary NMEA field types into /fix/ members.
 
     bool parseFix        ( char chr ); // aka STATUS or MODE
+    bool parseGNSMode    ( char chr ); // one MODE char per GNSS
     bool parseTime       ( char chr );
     bool parseDDMMYY     ( char chr );
     bool parseLat        ( char chr );
@@ -240,6 +592,7 @@
     bool parseSpeed      ( char chr );
     bool parseSpeedKph   ( char chr );
     bool parseHeading    ( char chr );
+    bool parseTrueHeading( char chr );
     bool parseAlt        ( char chr );
     bool parseGeoidHeight( char chr );
     bool parseHDOP       ( char chr );
@@ -249,6 +602,7 @@
     bool parse_lon_err   ( char chr );
     bool parse_alt_err   ( char chr );
     bool parseSatellites ( char chr );
+    bool parseDatum      ( char chr );
 
     // Helper macro for parsing the 4 consecutive fields of a location
     #define PARSE_LOC(i) case i: return parseLat( chr );\
@@ -256,6 +610,63 @@
       case i+2: return parseLon( chr ); \
       case i+3: return parseEW ( chr );
 
+    //.......................................................................
+    //  Sentence schemas.  A schema is a PROGMEM array with one converter
+    //    for each field index of a sentence type, up to its last parsed
+    //    field.  The converter for the current /fieldIndex/ is looked
+    //    up when the field begins, /parseField/ dispatches it with one
+    //    switch, and /parsedFields/ is built from the converters that
+    //    are enabled.  Adding a sentence is just another schema.
+    //
+    //    Derived classes can use schemas for their own sentences (see
+    //    /sentenceSchema/).  Their own converters are numbered from
+    //    FIELD_DERIVED, and they must be handled by the derived
+    //    /parseField/.  The converters
+    //    (field_t) are public, so that a BasicNMEAGPS configuration
+    //    can select them.
+
+    struct schema_t {
+      uint8_t        count;  // number of entries in /fields/
+      const uint8_t *fields; // a field_t for each field index
+    };
+
+    //  The converter for the current /fieldIndex/, or FIELD_SKIP.
+    static uint8_t schemaField( const schema_t *schema, uint8_t index )
+      {
+        uint8_t count = pgm_read_byte( &schema->count );
+        if (index >= count)
+          return FIELD_SKIP;
+        const uint8_t *fields = (const uint8_t *) pgm_read_ptr( &schema->fields );
+        return pgm_read_byte( &fields[ index ] );
+      }
+
+    //  The fields that have an enabled converter (see /parsedFields/).
+    //    The converter must also be one of /converters/, and with
+    //    NMEAGPS_RUNTIME_PROFILE, it must set a member in the profile.
+    uint32_t schemaMask
+      ( const schema_t *schema, uint32_t converters = 0xFFFFFFFFUL ) const;
+
+    //  Dispatch one character to a standard converter.
+    bool parseConverter( uint8_t field, char chr );
+
+    //  The schema for a standard sentence type, or NULL if it is
+    //    not parsed by a schema (e.g., GSA and GSV).
+    static const schema_t *schemaFor( nmea_msg_t msg );
+
+    //  The schema of the current sentence, or NULL.  Derived classes
+    //    return the schemas of their own sentences.
+    NMEAGPS_VIRTUAL const schema_t *sentenceSchema() const
+      { return schemaFor( nmeaMessage ); }
+
+    //  Called when a parsed field begins, so the schema is not read
+    //    again for each character of the field (see /parseField/).
+    void fieldBegins()
+      {
+        const schema_t *schema = sentenceSchema();
+        _converter = schema ? schemaField( schema, fieldIndex )
+                            : (uint8_t) FIELD_SKIP;
+      }
+
     //.......................................................................
     // Parse floating-point numbers into a /whole_frac/
     // @return true when the value is fully populated.
@@ -0,0 +1,186 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NMEAframe.h"
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+using NeoGPS::NMEAframe;
+
+//----------------------------------------------------------------
+// Same as the NMEAGPS checksum parser, so that the same chars
+//   are accepted.
+
+inline static uint8_t parseHEX(char a)
+{
+  a |= 0x20; // make it lowercase
+  if (('a' <= a) && (a <= 'f'))
+      return a - 'a' + 10;
+  else
+      return a - '0';
+}
+
+//----------------------------------------------------------------
+
+inline static bool endsFrame( uint8_t c )
+{
+  return (c == '*') || (c == '$') || (c < ' ') || ('~' < c);
+}
+
+//----------------------------------------------------------------
+// Record the offsets of the commas marked by /bits/, relative to
+//   the '$'.  Bit 0 is the char at /offset/.
+
+void NMEAframe::addCommas( uint32_t bits, uint8_t offset )
+{
+  while (bits) {
+    uint8_t i = __builtin_ctz( bits );
+    if (commas < MAX_COMMAS)
+      comma[ commas ] = offset + i;
+    commas++;
+    bits &= bits-1; // clear lowest bit
+  }
+
+} // addCommas
+
+//----------------------------------------------------------------
+
+NMEAframe::frame_t NMEAframe::scan( const uint8_t *buf, size_t len )
+{
+  uint8_t n = (len > MAX_LENGTH) ? MAX_LENGTH : len;
+
+  commas = 0;
+  crc    = 0;
+
+  uint8_t i = 1; // skip the '$'
+
+  #ifdef __SSE2__
+    // Examine 16 chars at a time.  Stop chars are '*', '$',
+    //   and anything outside ' '..'~'.  As signed chars, the
+    //   non-printable chars are < ' ' or == 0x7F.
+    const __m128i stars      = _mm_set1_epi8( '*' );
+    const __m128i dollars    = _mm_set1_epi8( '$' );
+    const __m128i separators = _mm_set1_epi8( ',' );
+    const __m128i spaces     = _mm_set1_epi8( ' ' );
+    const __m128i dels       = _mm_set1_epi8( 0x7F );
+          __m128i sum        = _mm_setzero_si128();
+
+    while (i + 16 <= n) {
+      __m128i chars = _mm_loadu_si128( (const __m128i *) &buf[i] );
+      __m128i stops =
+        _mm_or_si128
+          ( _mm_or_si128( _mm_cmpeq_epi8( chars, stars ),
+                          _mm_cmpeq_epi8( chars, dollars ) ),
+            _mm_or_si128( _mm_cmplt_epi8( chars, spaces ),
+                          _mm_cmpeq_epi8( chars, dels ) ) );
+      uint32_t stopBits  = _mm_movemask_epi8( stops );
+      uint32_t commaBits = _mm_movemask_epi8( _mm_cmpeq_epi8( chars, separators ) );
+
+      if (stopBits)
+        break; // the chars in this block are checked one at a time
+
+      sum = _mm_xor_si128( sum, chars );
+      addCommas( commaBits, i );
+      i  += 16;
+    }
+
+    // Fold the 16 partial checksums into one
+    sum = _mm_xor_si128( sum, _mm_srli_si128( sum, 8 ) );
+    sum = _mm_xor_si128( sum, _mm_srli_si128( sum, 4 ) );
+    sum = _mm_xor_si128( sum, _mm_srli_si128( sum, 2 ) );
+    sum = _mm_xor_si128( sum, _mm_srli_si128( sum, 1 ) );
+    crc = (uint8_t) _mm_cvtsi128_si32( sum );
+  #endif
+
+  // Scan (the rest of) the sentence.
+  for (; i < n; i++) {
+    uint8_t c = buf[i];
+    if (endsFrame( c ))
+      break;
+    crc ^= c;
+    if (c == ',') {
+      if (commas < MAX_COMMAS)
+        comma[ commas ] = i;
+      commas++;
+    }
+  }
+
+  // Must have found a '*' followed by two checksum chars.
+  if ((i + 2 >= n) || (buf[i] != '*') ||
+      (buf[i+1] == '$') || (buf[i+2] == '$'))
+    return FRAME_INCOMPLETE;
+
+  crcIndex = i;
+  length   = i + 3;
+
+  if ((parseHEX( buf[i+1] ) == (crc >> 4)) &&
+      (parseHEX( buf[i+2] ) == (crc & 0x0F)))
+    return FRAME_OK;
+
+  return FRAME_BAD_CRC;
+
+} // scan
+
+//----------------------------------------------------------------
+
+size_t NMEAframe::skip( const uint8_t *buf, size_t len, uint8_t & crc )
+{
+  size_t i = 0;
+
+  #ifdef __SSE2__
+    // Same stop chars as /scan/, 16 at a time.
+    const __m128i stars   = _mm_set1_epi8( '*' );
+    const __m128i dollars = _mm_set1_epi8( '$' );
+    const __m128i spaces  = _mm_set1_epi8( ' ' );
+    const __m128i dels    = _mm_set1_epi8( 0x7F );
+          __m128i sum     = _mm_setzero_si128();
+
+    while (i + 16 <= len) {
+      __m128i chars = _mm_loadu_si128( (const __m128i *) &buf[i] );
+      __m128i stops =
+        _mm_or_si128
+          ( _mm_or_si128( _mm_cmpeq_epi8( chars, stars ),
+                          _mm_cmpeq_epi8( chars, dollars ) ),
+            _mm_or_si128( _mm_cmplt_epi8( chars, spaces ),
+                          _mm_cmpeq_epi8( chars, dels ) ) );
+
+      if (_mm_movemask_epi8( stops ))
+        break;
+
+      sum = _mm_xor_si128( sum, chars );
+      i  += 16;
+    }
+
+    sum  = _mm_xor_si128( sum, _mm_srli_si128( sum, 8 ) );
+    sum  = _mm_xor_si128( sum, _mm_srli_si128( sum, 4 ) );
+    sum  = _mm_xor_si128( sum, _mm_srli_si128( sum, 2 ) );
+    sum  = _mm_xor_si128( sum, _mm_srli_si128( sum, 1 ) );
+    crc ^= (uint8_t) _mm_cvtsi128_si32( sum );
+  #endif
+
+  for (; i < len; i++) {
+    uint8_t c = buf[i];
+    if (endsFrame( c ))
+      break;
+    crc ^= c;
+  }
+
+  return i;
+
+} // skip
@@ -0,0 +1,89 @@
+#ifndef NMEAFRAME_H
+#define NMEAFRAME_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NeoGPS_cfg.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NeoGPS {
+
+//------------------------------------------------------
+//
+// Locates the boundaries of one NMEA sentence in a block of
+// characters that is already in memory.  The sentence must start
+// with the '$' at buf[0].  The scan stops at the first '*', '$' or
+// non-printable character.  If it was a '*', and the two checksum
+// characters are also in the block, the XOR checksum of the
+// sentence is verified.
+//
+// The offsets of the field separators (commas) are also
+// recorded, so that the fields can be accessed directly.
+//
+// On hosts with SSE2, 16 characters are examined at a time.
+
+class NMEAframe
+{
+public:
+
+  // Offsets are 8 bits, so a frame can only be this long
+  CONST_CLASS_DATA uint8_t MAX_LENGTH = 255;
+
+  // Only this many comma offsets are recorded
+  CONST_CLASS_DATA uint8_t MAX_COMMAS = 31;
+
+  enum frame_t
+    {
+      FRAME_INCOMPLETE, // not a complete, printable sentence in the block
+      FRAME_OK,         // checksum is correct
+      FRAME_BAD_CRC     // checksum does not match
+    };
+
+  frame_t scan( const uint8_t *buf, size_t len );
+
+  uint8_t length;      // chars from '$' through the 2nd checksum char
+  uint8_t crcIndex;    // offset of the '*'
+  uint8_t crc;         // XOR of the chars between '$' and '*'
+  uint8_t commas;      // may be larger than MAX_COMMAS
+  uint8_t comma[ MAX_COMMAS ]; // offsets of each ','
+
+  bool allCommas() const { return (commas <= MAX_COMMAS); };
+
+  //  XOR the chars of a sentence into /crc/, up to (but not including)
+  //  the first '*', '$' or non-printable character.  Returns the number
+  //  of chars that were added, which is /len/ if none of those chars
+  //  were found.  Used for the rest of a sentence that is not parsed.
+  static size_t skip( const uint8_t *buf, size_t len, uint8_t & crc );
+
+  //  Return the offset of the first char of field /i/.  Field 0 is
+  //  the sentence type (e.g., "GPGGA").  The field ends at the
+  //  start of the next field, minus one.
+  uint8_t fieldStart( uint8_t i ) const
+    { return (i == 0) ? 1 : comma[i-1] + 1; };
+  uint8_t fieldEnd( uint8_t i ) const
+    { return (i < commas) ? comma[i] : crcIndex; };
+
+private:
+  void addCommas( uint32_t bits, uint8_t offset );
+
+};
+
+} // namespace NeoGPS
+
+#endif
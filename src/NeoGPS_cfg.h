@@ -62,6 +62,19 @@
 
 #endif
 
+//------------------------------------------------------------------------
+// The fix buffer is a single-producer, single-consumer ring (see
+// NMEAGPSprivate.h).  On a host or a multi-core MCU, the parser and the
+// reader may be different threads, so the ring indices are accessed with
+// the GCC atomic builtins.  On other MCUs, the parser is either loop() or
+// an ISR, so volatile access and disabling interrupts are sufficient.
+
+#if defined(__GCC_ATOMIC_CHAR_LOCK_FREE) && \
+    (__GCC_ATOMIC_CHAR_LOCK_FREE == 2)   && \
+    !defined(__AVR__)
+  #define NEOGPS_ATOMIC_INDICES
+#endif
+
 //------------------------------------------------------------------------
 //  Accommodate C++ compiler and IDE changes.
 //
@@ -122,4 +135,14 @@
 #endif
 
 
+//------------------------------------------------------------------------
+// Location_t distance, bearing and offset are normally calculated with
+//    float math (Location.cpp).  Enable this to calculate them with
+//    64-bit integers instead (LocationFixed.cpp).  These versions do not
+//    use the float math library, and they are more accurate, especially
+//    for short distances.  The results are still returned as float
+//    radians.  See Location.md.
+
+//#define NEOGPS_FIXED_POINT_LOCATION
+
 #endif
@@ -0,0 +1,391 @@
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "SatelliteTable.h"
+
+#ifdef NMEAGPS_SATELLITE_TABLE
+
+#include <string.h>
+
+using NeoGPS::SatelliteTable_t;
+
+//----------------------------------------------------------------
+
+void SatelliteTable_t::init()
+{
+  count     = 0;
+  _reported = false;
+  _listed   = false;
+  memset( _index, 0, sizeof(_index) );
+
+  _generation = 0;
+
+} // init
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::find( uint8_t sys, uint8_t id ) const
+{
+  uint8_t h = hash( sys, id );
+
+  for (;;) {
+    uint8_t entry = _index[h];
+    if (entry == 0)
+      return NOT_FOUND;
+
+    entry--;
+    if ((prn[entry] == id) && (system[entry] == sys))
+      return entry;
+
+    if (++h == INDEX_SIZE)
+      h = 0;
+  }
+
+} // find
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::insert( uint8_t sys, uint8_t id )
+{
+  uint8_t h = hash( sys, id );
+
+  for (;;) {
+    uint8_t entry = _index[h];
+    if (entry == 0)
+      break;
+
+    entry--;
+    if ((prn[entry] == id) && (system[entry] == sys))
+      return entry;
+
+    if (++h == INDEX_SIZE)
+      h = 0;
+  }
+
+  if (count >= CAPACITY)
+    return NOT_FOUND;
+
+  //  Not found, add it at the end.  The index is never more than
+  //    half full, so there was an empty slot.
+  uint8_t i = count++;
+  prn      [i] = id;
+  system   [i] = sys;
+  signal   [i] = 0;
+  elevation[i] = 0;
+  azimuth  [i] = 0;
+  snr      [i] = 0;
+  flags    [i] = 0;
+  _index   [h] = i+1;
+
+  return i;
+
+} // insert
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::update
+  ( uint8_t sys, uint8_t id, uint8_t sig,
+    uint8_t elev, uint16_t az, uint8_t cno, bool tracked )
+{
+  changing();
+
+  uint8_t i = insert( sys, id );
+
+  if (i != NOT_FOUND) {
+    elevation[i] = elev;
+    azimuth  [i] = az;
+
+    if (!tracked)
+      cno = 0;
+
+    //  The first report in this interval sets the SNR.  A later
+    //    report of another signal replaces it if it is tracked and
+    //    the current SNR is not, or if it has a lower signal ID.
+    if (!(flags[i] & SEEN) ||
+        ((cno > 0) && ((snr[i] == 0) || (sig <= signal[i])))) {
+      snr   [i] = cno;
+      signal[i] = sig;
+    }
+
+    flags[i] |= SEEN;
+    _reported = true;
+  }
+
+  return i;
+
+} // update
+
+//----------------------------------------------------------------
+
+void SatelliteTable_t::used( uint8_t sys, uint8_t id )
+{
+  changing();
+
+  uint8_t i = insert( sys, id );
+
+  if (i != NOT_FOUND) {
+    flags[i] |= (SEEN | LISTED);
+    _reported = true;
+  }
+  _listed = true;
+
+} // used
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::tracked() const
+{
+  uint8_t n = 0;
+  for (uint8_t i=0; i < count; i++)
+    n += ((flags[i] & SEEN) && (snr[i] != 0));
+  return n;
+
+} // tracked
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::listed() const
+{
+  uint8_t n = 0;
+  for (uint8_t i=0; i < count; i++)
+    n += ((flags[i] & LISTED) != 0);
+  return n;
+
+} // listed
+
+//----------------------------------------------------------------
+
+void SatelliteTable_t::endInterval()
+{
+  if (_reported) {
+    // Age the satellites that were not reported, and remove the
+    //   ones that are too old.
+    uint8_t n = 0;
+
+    for (uint8_t i=0; i < count; i++) {
+      uint8_t f   = flags[i];
+      uint8_t cno = snr[i];
+      if (f & SEEN)
+        f &= ~AGE_MASK;
+      else {
+        f  += AGE_1;
+        cno = 0; // not tracked now
+      }
+
+      if ((f >> AGE_SHIFT) < NMEAGPS_SATELLITE_MAX_AGE) {
+        if (n != i) {
+          prn      [n] = prn      [i];
+          system   [n] = system   [i];
+          signal   [n] = signal   [i];
+          elevation[n] = elevation[i];
+          azimuth  [n] = azimuth  [i];
+        }
+        snr  [n] = cno;
+        flags[n] = f;
+        n++;
+      }
+    }
+
+    if (n != count) {
+      count = n;
+      rebuildIndex();
+    }
+  }
+
+  //  Only the satellites in the latest GSA(s) are used.
+  if (_listed) {
+    for (uint8_t i=0; i < count; i++) {
+      if (flags[i] & LISTED)
+        flags[i] |= USED;
+      else
+        flags[i] &= ~USED;
+    }
+  }
+
+  for (uint8_t i=0; i < count; i++)
+    flags[i] &= ~(SEEN | LISTED);
+
+  _reported = false;
+  _listed   = false;
+
+  if (_generation & 1) {
+    barrier();
+    nextGeneration(); // even: complete
+  }
+
+} // endInterval
+
+//----------------------------------------------------------------
+
+void SatelliteTable_t::rebuildIndex()
+{
+  memset( _index, 0, sizeof(_index) );
+
+  for (uint8_t i=0; i < count; i++) {
+    uint8_t h = hash( system[i], prn[i] );
+    while (_index[h] != 0) {
+      if (++h == INDEX_SIZE)
+        h = 0;
+    }
+    _index[h] = i+1;
+  }
+
+} // rebuildIndex
+
+//----------------------------------------------------------------
+
+SatelliteTable_t::satellite_t SatelliteTable_t::operator []( uint8_t i ) const
+{
+  satellite_t sat;
+
+  sat.id        = prn      [i];
+  sat.system    = system   [i];
+  sat.signal    = signal   [i];
+  sat.elevation = elevation[i];
+  sat.azimuth   = azimuth  [i];
+  sat.snr       = snr      [i];
+  sat.tracked   = (snr[i] != 0);
+  sat.used      = (flags[i] & USED);
+  sat.age       = (flags[i] >> AGE_SHIFT);
+
+  return sat;
+
+} // operator []
+
+//----------------------------------------------------------------
+
+bool SatelliteTable_t::snapshot( SatelliteTable_t & copy ) const
+{
+  uint8_t g = generation();
+  if (g & 1)
+    return false;
+
+  memcpy( &copy, this, sizeof(copy) );
+  barrier();
+
+  return (generation() == g);
+
+} // snapshot
+
+//----------------------------------------------------------------
+//  The loop has no early exits or nested branches, so the compiler
+//    can vectorize it.
+
+SatelliteTable_t::summary_t SatelliteTable_t::summary( uint8_t sys ) const
+{
+  summary_t s;
+  s.visible = 0;
+  s.tracked = 0;
+  s.used    = 0;
+  s.snr_max = 0;
+  s.snr_sum = 0;
+
+  for (uint8_t i=0; i < count; i++) {
+    bool    match = (sys == SYS_UNKNOWN) || (system[i] == sys);
+    uint8_t cno   = match ? snr[i] : 0;
+
+    s.visible += match;
+    s.tracked += (cno != 0);
+    s.used    += match & ((flags[i] & USED) != 0);
+    s.snr_sum += cno;
+    if (s.snr_max < cno)
+      s.snr_max = cno;
+  }
+
+  return s;
+
+} // summary
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::systemFor( char talker0, char talker1 )
+{
+  if (talker0 == 'G') {
+    switch (talker1) {
+      case 'P': return SYS_GPS;
+      case 'L': return SYS_GLONASS;
+      case 'A': return SYS_GALILEO;
+      case 'B': return SYS_BEIDOU;
+      case 'Q': return SYS_QZSS;
+      case 'I': return SYS_NAVIC;
+    }
+  } else if ((talker0 == 'B') && (talker1 == 'D')) {
+    return SYS_BEIDOU;
+  } else if ((talker0 == 'Q') && (talker1 == 'Z')) {
+    return SYS_QZSS;
+  }
+
+  return SYS_UNKNOWN; // e.g., "GN"
+
+} // systemFor
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::systemForID( uint8_t systemID )
+{
+  switch (systemID) {
+    case 1: return SYS_GPS;
+    case 2: return SYS_GLONASS;
+    case 3: return SYS_GALILEO;
+    case 4: return SYS_BEIDOU;
+    case 5: return SYS_QZSS;
+    case 6: return SYS_NAVIC;
+  }
+
+  return SYS_UNKNOWN;
+
+} // systemForID
+
+//----------------------------------------------------------------
+
+uint8_t SatelliteTable_t::systemFor( uint8_t sys, uint8_t id )
+{
+  //  Other talkers use their own PRN numbering.
+  if ((sys == SYS_GPS) || (sys == SYS_UNKNOWN)) {
+    if ((1 <= id) && (id <= 32))
+      sys = SYS_GPS;
+    else if ((33 <= id) && (id <= 64))
+      sys = SYS_SBAS;
+    else if ((65 <= id) && (id <= 96))
+      sys = SYS_GLONASS;
+    else if ((193 <= id) && (id <= 202))
+      sys = SYS_QZSS;
+  }
+
+  return sys;
+
+} // systemFor
+
+//----------------------------------------------------------------
+
+char SatelliteTable_t::systemChar( uint8_t sys )
+{
+  switch (sys) {
+    case SYS_GPS    : return 'P';
+    case SYS_SBAS   : return 'S';
+    case SYS_GLONASS: return 'L';
+    case SYS_GALILEO: return 'A';
+    case SYS_BEIDOU : return 'B';
+    case SYS_QZSS   : return 'Q';
+    case SYS_NAVIC  : return 'I';
+  }
+
+  return '?';
+
+} // systemChar
+
+#endif // NMEAGPS_SATELLITE_TABLE
@@ -0,0 +1,246 @@
+#ifndef SATELLITETABLE_H
+#define SATELLITETABLE_H
+
+//  Copyright (C) 2014-2017, SlashDevin
+//
+//  This file is part of NeoGPS
+//
+//  NeoGPS is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  NeoGPS is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with NeoGPS.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "NeoGPS_cfg.h"
+#include "NMEAGPS_cfg.h"
+
+// Disable the entire file if the satellite table is not used.
+#ifdef NMEAGPS_SATELLITE_TABLE
+
+#include <stdint.h>
+
+namespace NeoGPS {
+
+//------------------------------------------------------
+//
+// The satellites in view, from all the constellations that a
+// receiver reports (e.g., GPS, GLONASS, Galileo and BeiDou).
+//
+// Each satellite is identified by its system and PRN, and it is
+// found through a small hash index, so updating one satellite does
+// not search the whole table.  Entries are updated in place as each
+// GSV page arrives.  Satellites that have not been reported for
+// NMEAGPS_SATELLITE_MAX_AGE intervals are removed when an update
+// interval ends.
+//
+// The generation counter is odd while the satellites of an interval
+// are being received, and even when the interval has ended.  A reader
+// can copy the table with /snapshot/ while the next GSV burst is
+// being parsed (e.g., during an ISR or on another thread), or watch
+// the generation change to know that a complete interval is available.
+//
+// The members are stored as separate arrays ("structure of arrays"),
+// so a loop over one member (e.g., the SNR of every satellite) only
+// reads that array.  Entries 0..count-1 are valid.  operator[]
+// returns one entry, like the satellites[] array of NMEAGPS.
+
+class SatelliteTable_t
+{
+public:
+
+  enum system_t
+    {
+      SYS_UNKNOWN,
+      SYS_GPS,
+      SYS_SBAS,
+      SYS_GLONASS,
+      SYS_GALILEO,
+      SYS_BEIDOU,
+      SYS_QZSS,
+      SYS_NAVIC,
+      SYSTEMS
+    };
+
+  CONST_CLASS_DATA uint8_t CAPACITY  = NMEAGPS_MAX_SATELLITES;
+  CONST_CLASS_DATA uint8_t NOT_FOUND = 0xFF;
+
+  //  Bits of the /flags/ array
+  enum
+    {
+      USED   = 0x01, // in the navigation solution (GSA or UBX)
+      SEEN   = 0x02, // reported in the current interval
+      LISTED = 0x04, // listed by a GSA in the current interval
+
+      AGE_SHIFT = 3, // the upper bits count the intervals since
+      AGE_1     = (1 << AGE_SHIFT), //   the last report
+      AGE_MASK  = (0xFF << AGE_SHIFT) & 0xFF
+    };
+
+  uint8_t  count;
+
+  uint8_t  prn      [ CAPACITY ];
+  uint8_t  system   [ CAPACITY ]; // system_t
+  uint8_t  signal   [ CAPACITY ]; // NMEA 4.10 signal ID of /snr/, or 0
+  uint8_t  elevation[ CAPACITY ]; // 0..90 deg
+  uint16_t azimuth  [ CAPACITY ]; // 0..359 deg
+  uint8_t  snr      [ CAPACITY ]; // 0..99 dBHz, 0 if not tracked
+  uint8_t  flags    [ CAPACITY ];
+
+  void init();
+
+  //  Return the entry for this satellite, or NOT_FOUND.
+  uint8_t find( uint8_t sys, uint8_t id ) const;
+
+  //  Return the entry for this satellite, adding it if necessary.
+  //    Returns NOT_FOUND if the table is full.
+  uint8_t insert( uint8_t sys, uint8_t id );
+
+  //  Set the position and SNR of one satellite, as reported on
+  //    /sig/ (0 if unknown).  If the satellite is reported on more
+  //    than one signal, the lowest tracked signal ID sets the SNR.
+  //    Returns the entry, or NOT_FOUND if the table is full.
+  uint8_t update
+    ( uint8_t sys, uint8_t id, uint8_t sig,
+      uint8_t elev, uint16_t az, uint8_t cno, bool tracked );
+
+  //  Mark one satellite as used in the solution.
+  void used( uint8_t sys, uint8_t id );
+
+  //  A report was received, even if it had no satellites.
+  void reported() { changing(); _reported = true; };
+
+  //  The number of satellites reported with an SNR, and the number
+  //    marked as used, in the current interval.
+  uint8_t tracked() const;
+  uint8_t listed () const;
+
+  //  The update interval has ended.  Satellites that were not
+  //    reported are removed, and satellites that were not listed by
+  //    a GSA are no longer used.  Nothing changes if there were no
+  //    reports (e.g., GSV is sent less often than the fix).
+  void endInterval();
+
+  //  One entry, as in the NMEAGPS satellites[] array.
+  struct satellite_t
+  {
+    uint8_t  id;
+    uint8_t  system;
+    uint8_t  signal;
+    uint8_t  elevation;
+    uint16_t azimuth;
+    uint8_t  snr;
+    bool     tracked;
+    bool     used;
+    uint8_t  age;      // intervals since the last report
+  };
+
+  satellite_t operator []( uint8_t i ) const;
+
+  //  Incremented when the satellites of an interval start to arrive
+  //    (odd), and again when the interval ends (even).
+  uint8_t generation() const
+    {
+      #ifdef NEOGPS_ATOMIC_INDICES
+        return __atomic_load_n( &_generation, __ATOMIC_ACQUIRE );
+      #else
+        return *((volatile const uint8_t *) &_generation);
+      #endif
+    };
+
+  //  Copy a complete interval into /copy/.  Returns false if an
+  //    interval is being received, or if one started during the copy.
+  bool snapshot( SatelliteTable_t & copy ) const;
+
+  //  A summary of one system, or all systems for SYS_UNKNOWN.
+  struct summary_t
+  {
+    uint8_t  visible;
+    uint8_t  tracked; // with an SNR
+    uint8_t  used;
+    uint8_t  snr_max;
+    uint16_t snr_sum; // of the tracked satellites
+
+    uint8_t snr_avg() const
+      { return tracked ? (uint8_t) (snr_sum / tracked) : 0; };
+  };
+
+  summary_t summary( uint8_t sys ) const;
+
+  //  The system for a talker ID (e.g., "GL" is SYS_GLONASS), or
+  //    SYS_UNKNOWN for "GN" and others.
+  static uint8_t systemFor( char talker0, char talker1 );
+
+  //  The system for an NMEA 4.10 system ID (GSA field 18).
+  static uint8_t systemForID( uint8_t systemID );
+
+  //  The system of one satellite.  The talker (or GSA system ID)
+  //    is refined by the NMEA PRN ranges: 33..64 are SBAS, 65..96
+  //    are GLONASS and 193..202 are QZSS.
+  static uint8_t systemFor( uint8_t sys, uint8_t id );
+
+  //  A character for printing the system: P(GPS), S(BAS), L(GLONASS),
+  //    A(Galileo), B(eiDou), Q(ZSS) or I(NavIC).
+  static char systemChar( uint8_t sys );
+
+private:
+  enum { INDEX_SIZE = 2 * NMEAGPS_MAX_SATELLITES };
+
+  //  Entry+1 for each hash slot, or 0 for an empty slot.
+  uint8_t  _index[ INDEX_SIZE ];
+  bool     _reported; // something was reported in this interval
+  bool     _listed;   // a GSA was received in this interval
+  uint8_t  _generation;
+
+  //  The generation is a sequence lock.  The table writes must not be
+  //    moved before an odd generation or after an even one, and the
+  //    /snapshot/ copy must not be moved after its second check.  On a
+  //    host (see NEOGPS_ATOMIC_INDICES), the parser and the reader may
+  //    be different threads, so this is a memory fence.  Otherwise, the
+  //    reader is loop() and the parser may be an ISR, so only the
+  //    compiler has to keep the order.
+
+  static void barrier()
+    {
+      #ifdef NEOGPS_ATOMIC_INDICES
+        __atomic_thread_fence( __ATOMIC_SEQ_CST );
+      #else
+        __asm__ __volatile__ ( "" ::: "memory" );
+      #endif
+    }
+
+  void nextGeneration()
+    {
+      #ifdef NEOGPS_ATOMIC_INDICES
+        __atomic_store_n( &_generation, (uint8_t) (_generation+1), __ATOMIC_RELAXED );
+      #else
+        *((volatile uint8_t *) &_generation) = _generation+1;
+      #endif
+    }
+
+  void changing()
+    {
+      if (!(_generation & 1)) {
+        nextGeneration(); // odd
+        barrier();
+      }
+    };
+
+  static uint8_t hash( uint8_t sys, uint8_t id )
+    { return (uint8_t) ((id + sys * 37U) % INDEX_SIZE); };
+
+  void rebuildIndex();
+
+};
+
+} // namespace NeoGPS
+
+#endif // NMEAGPS_SATELLITE_TABLE
+
+#endif
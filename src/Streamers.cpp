@@ -73,6 +73,10 @@ const char gps_fix_header[] __PROGMEM =
     "Hdg,"
   #endif
 
+  #if defined(GPS_FIX_TRUE_HEADING)
+    "True Hdg,"
+  #endif
+
   #if defined(GPS_FIX_SPEED)
     "Spd,"
   #endif
@@ -125,6 +129,10 @@ const char gps_fix_header[] __PROGMEM =
     "Geoid Ht,"
   #endif
 
+  #if defined(GPS_FIX_DATUM)
+    "Datum,"
+  #endif
+
   #if defined(GPS_FIX_SATELLITES)
     "Sats,"
   #endif
@@ -227,6 +235,11 @@ Print & operator <<( Print &outs, const gps_fix &fix )
         outs.print( fix.heading(), 2 );
       outs << ',';
     #endif
+    #ifdef GPS_FIX_TRUE_HEADING
+      if (fix.valid.trueHeading)
+        outs.print( fix.true_heading(), 2 );
+      outs << ',';
+    #endif
     #ifdef GPS_FIX_SPEED
       if (fix.valid.speed)
         outs.print( fix.speed(), 3 ); // knots
@@ -330,6 +343,11 @@ Print & operator <<( Print &outs, const gps_fix &fix )
         outs << fix.heading_cd();
       outs << ',';
     #endif
+    #ifdef GPS_FIX_TRUE_HEADING
+      if (fix.valid.trueHeading)
+        outs << fix.true_heading_cd();
+      outs << ',';
+    #endif
     #ifdef GPS_FIX_SPEED
       if (fix.valid.speed)
         outs << fix.speed_mkn();
@@ -407,6 +425,12 @@ Print & operator <<( Print &outs, const gps_fix &fix )
     
   #endif
 
+  #ifdef GPS_FIX_DATUM
+    if (fix.valid.datum)
+      outs.print( fix.datum );
+    outs << ',';
+  #endif
+
   #ifdef GPS_FIX_SATELLITES
     if (fix.valid.satellites)
       outs << fix.satellites;
@@ -460,6 +484,10 @@ void trace_all( Print & outs, const NMEAGPS &gps, const gps_fix &fix )
     outs << '[';
 
     for (uint8_t i=0; i < gps.sat_count; i++) {
+      #if defined(NMEAGPS_SATELLITE_TABLE)
+        // PRNs are only unique within a system
+        outs << NeoGPS::SatelliteTable_t::systemChar( gps.satellites.system[i] );
+      #endif
       outs << gps.satellites[i].id;
 
       #if defined(NMEAGPS_PARSE_SATELLITE_INFO)
@@ -487,3 +515,102 @@ void trace_all( Print & outs, const NMEAGPS &gps, const gps_fix &fix )
   outs << '\n';
 
 } // trace_all
+
+//--------------------------
+
+void trace_statistics( Print & outs, const NMEAGPS &gps )
+{
+  #ifdef NMEAGPS_STATS
+    outs << F("Rx ok,") << gps.statistics.ok     << '\n'
+         << F("Rx err,") << gps.statistics.errors << '\n'
+         << F("Rx chars,") << gps.statistics.chars  << '\n';
+  #endif
+
+  #ifdef NMEAGPS_EXTENDED_STATS
+    for (uint8_t i=0; i < NMEAGPS_STATS_MSGS; i++) {
+      const NMEAGPS::msg_statistics_t & msg = gps.statistics.messages[i];
+      if (msg.ok || msg.errors) {
+        const __FlashStringHelper *name = gps.string_for( (NMEAGPS::nmea_msg_t) i );
+        if (name)
+          outs << name;
+        else
+          outs << i;
+        outs << F(" ok,") << msg.ok << F(",err,") << msg.errors << '\n';
+      }
+    }
+
+    outs << F("unrecognized,") << gps.statistics.unrecognized << '\n'
+         << F("discarded,")    << gps.statistics.discarded    << '\n';
+
+    const NMEAGPS::interval_statistics_t & interval = gps.statistics.interval;
+    outs << F("intervals,") << interval.count;
+    if (interval.count)
+      outs << F(",min us,") << interval.min_us << F(",max us,") << interval.max_us;
+    outs << '\n';
+
+    //  Each bucket is up to 1024us * 2^i (approximately 2^i ms)
+    outs << F("interval ms");
+    uint32_t ms = 1;
+    for (uint8_t i=0; i < interval.BUCKETS; i++, ms <<= 1) {
+      outs << ',';
+      if (i < interval.BUCKETS-1)
+        outs << '<' << ms;
+      else
+        outs << F(">=") << (ms >> 1);
+      outs << ':' << interval.histogram[i];
+    }
+    outs << '\n';
+  #endif
+
+} // trace_statistics
+
+//--------------------------
+
+#ifdef NMEAGPS_TRACE_LATENCY
+
+static const char latency_header[] __PROGMEM =
+  "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"NeoGPS\"}},\n"
+  "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"parser\"}},\n"
+  "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"fix buffer\"}},\n"
+  "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"application\"}}";
+
+void trace_latency_header( Print & outs )
+{
+  outs.print( (const __FlashStringHelper *) &latency_header[0] );
+  outs << '\n';
+}
+
+//--------------------------
+//  One "complete" event.  Each one starts with a comma, so that the
+//    trace is valid JSON whenever the ']' is added.
+
+static void trace_event
+  ( Print & outs, const __FlashStringHelper *name, uint8_t tid,
+    uint32_t start, uint32_t end )
+{
+  outs << F(",{\"name\":\"") << name
+       << F("\",\"ph\":\"X\",\"pid\":1,\"tid\":") << tid
+       << F(",\"ts\":") << start
+       << F(",\"dur\":") << (uint32_t) (end - start)
+       << F("}\n");
+}
+
+void trace_latency( Print & outs, const NMEAGPS &gps )
+{
+  const NMEAGPS::fix_trace_t & t = gps.trace;
+
+  trace_event( outs, F("interval"), 1, t.firstChar   , t.lastSentence );
+  trace_event( outs, F("store")   , 1, t.lastSentence, t.stored       );
+  trace_event( outs, F("queued")  , 2, t.stored      , t.read         );
+  trace_event( outs, F("handled") , 3, t.read        , micros()       );
+
+} // trace_latency
+
+#else
+
+//  Nothing to print.
+
+void trace_latency_header( Print & ) {}
+void trace_latency( Print &, const NMEAGPS & ) {}
+
+#endif
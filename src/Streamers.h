@@ -47,4 +47,34 @@ class NMEAGPS;
 extern void trace_header( Print & outs );
 extern void trace_all( Print & outs, const NMEAGPS &gps, const gps_fix &fix );
 
+/**
+ * Print the parser statistics, one item per line.  The sentence type
+ * counts and interval timing are only available if
+ * NMEAGPS_EXTENDED_STATS is enabled in NMEAGPS_cfg.h.
+ * @param[in] outs output stream.
+ * @param[in] gps NMEAGPS instance.
+ */
+extern void trace_statistics( Print & outs, const NMEAGPS &gps );
+
+/**
+ * Print the beginning of a Chrome trace (JSON Array Format), which can
+ * be loaded in chrome://tracing or ui.perfetto.dev.  Then call
+ * trace_latency after each fix has been handled.  The closing ']' is
+ * optional, so the trace can simply be cut off.  Nothing is printed
+ * unless NMEAGPS_TRACE_LATENCY is enabled in NMEAGPS_cfg.h.
+ * @param[in] outs output stream.
+ */
+extern void trace_latency_header( Print & outs );
+
+/**
+ * Print the timestamps of the last fix returned by read or peek as
+ * Chrome trace events: "interval" (parsing the sentences), "store",
+ * "queued" (waiting in the fix buffer) and "handled" (from read until
+ * this call).  Nothing is printed unless NMEAGPS_TRACE_LATENCY is
+ * enabled in NMEAGPS_cfg.h.
+ * @param[in] outs output stream.
+ * @param[in] gps NMEAGPS instance.
+ */
+extern void trace_latency( Print & outs, const NMEAGPS &gps );
+
 #endif
\ No newline at end of file
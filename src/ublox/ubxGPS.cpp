@@ -53,6 +53,10 @@ using namespace ublox;
 
 void ubloxGPS::rxBegin()
 {
+  #ifdef NMEAGPS_TRACE_LATENCY
+    traceBegin();
+  #endif
+
   if (intervalComplete()) {
     // GPS quiet time is over, this is the start of a new interval.
 
@@ -61,6 +65,10 @@ void ubloxGPS::rxBegin()
       _IntervalStart = micros();
     #endif
 
+    #ifdef NMEAGPS_EXTENDED_STATS
+      statsIntervalBegin();
+    #endif
+
     intervalComplete( false );
   }
 
@@ -89,6 +97,11 @@ bool ubloxGPS::rxEnd()
     #ifdef NMEAGPS_STATS
       statistics.ok++;
     #endif
+    #ifdef NMEAGPS_EXTENDED_STATS
+      ubx_statistics_t *stats = ubx_statistics_for( rx() );
+      if (stats)
+        stats->ok++;
+    #endif
 
     visible_msg = true;
 //if (!visible_msg) trace << F("XXX");
@@ -115,6 +128,47 @@ bool ubloxGPS::rxEnd()
 
 //---------------------------------------------------------
 
+#ifdef NMEAGPS_EXTENDED_STATS
+
+void ubloxGPS::ubx_statistics_init()
+{
+  for (uint8_t i=0; i < UBLOX_STATS_MSGS; i++) {
+    ubx_statistics[i].msg_class = UBX_UNK;
+    ubx_statistics[i].msg_id    = UBX_ID_UNK;
+    ubx_statistics[i].ok        = 0;
+    ubx_statistics[i].errors    = 0;
+  }
+
+} // ubx_statistics_init
+
+//---------------------------------------------------------
+//  Find the counters for this message type, or claim an unused entry.
+
+ubloxGPS::ubx_statistics_t *ubloxGPS::ubx_statistics_for( const msg_t & msg )
+{
+  if ((msg.msg_class == UBX_UNK) || (msg.msg_class == UBX_ACK))
+    return (ubx_statistics_t *) NULL;
+
+  for (uint8_t i=0; i < UBLOX_STATS_MSGS; i++) {
+    ubx_statistics_t & stats = ubx_statistics[i];
+
+    if (stats.msg_class == UBX_UNK) {
+      stats.msg_class = msg.msg_class;
+      stats.msg_id    = msg.msg_id;
+      return &stats;
+    }
+    if ((stats.msg_class == msg.msg_class) && (stats.msg_id == msg.msg_id))
+      return &stats;
+  }
+
+  return (ubx_statistics_t *) NULL;
+
+} // ubx_statistics_for
+
+#endif
+
+//---------------------------------------------------------
+
 static char toHexDigit( uint8_t val )
 {
   val &= 0x0F;
@@ -188,6 +242,7 @@ ubloxGPS::decode_t ubloxGPS::decode( char c )
               chrCount = 0;
               rxState = (rxState_t) UBX_RECEIVING_DATA;
               
+              shadowFix();
               NMEAGPS_INIT_FIX(m_fix);
               
               if (rx().msg_class == UBX_ACK) {
@@ -225,8 +280,13 @@ ubloxGPS::decode_t ubloxGPS::decode( char c )
 
       case UBX_CRC_A:
           if (chr != m_rx_msg.crc_a) {
-            // All the values are suspect.  Start over.
-            m_fix.valid.init();
+            #ifdef NMEAGPS_EXTENDED_STATS
+              ubx_statistics_t *stats = ubx_statistics_for( rx() );
+              if (stats)
+                stats->errors++;
+            #endif
+            // The values from this message are suspect.
+            rejectFix();
             rx().msg_class = UBX_UNK;
             #ifdef NMEAGPS_STATS
               statistics.errors++;
@@ -237,8 +297,14 @@ ubloxGPS::decode_t ubloxGPS::decode( char c )
 
       case UBX_CRC_B:
           if (chr != m_rx_msg.crc_b) {
-            // All the values are suspect.  Start over.
-            m_fix.valid.init();
+            #ifdef NMEAGPS_EXTENDED_STATS
+              // Not counted again if CRC_A was also wrong
+              ubx_statistics_t *stats = ubx_statistics_for( rx() );
+              if (stats)
+                stats->errors++;
+            #endif
+            // The values from this message are suspect.
+            rejectFix();
             rx().msg_class = UBX_UNK;
             #ifdef NMEAGPS_STATS
               statistics.errors++;
@@ -1263,6 +1329,48 @@ bool ubloxGPS::parseNavTimeUTC( uint8_t chr )
 
 //---------------------------------------------------------
 
+#ifdef NMEAGPS_SATELLITE_TABLE
+
+//  The system of a NAV-SVINFO svid.  The svid is changed to the PRN
+//    used in NMEA sentences for that system.
+
+uint8_t ubloxGPS::svSystem( uint8_t & id )
+{
+  typedef NeoGPS::SatelliteTable_t table_t;
+
+  if (id <= 32)
+    return table_t::SYS_GPS;
+  if (id <= 64) {
+    id -= 32;
+    return table_t::SYS_BEIDOU;
+  }
+  if (id <= 96)
+    return table_t::SYS_GLONASS;
+  if ((120 <= id) && (id <= 158)) {
+    id -= 87;
+    return table_t::SYS_SBAS;
+  }
+  if ((159 <= id) && (id <= 163)) {
+    id -= 158;
+    return table_t::SYS_BEIDOU;
+  }
+  if ((193 <= id) && (id <= 197))
+    return table_t::SYS_QZSS;
+  if ((211 <= id) && (id <= 246)) {
+    id -= 210;
+    return table_t::SYS_GALILEO;
+  }
+  if (id == 255)
+    return table_t::SYS_GLONASS; // unknown slot
+
+  return table_t::SYS_UNKNOWN;
+
+} // svSystem
+
+#endif
+
+//---------------------------------------------------------
+
 bool ubloxGPS::parseNavSVInfo( uint8_t chr )
 {
   bool ok = true;
@@ -1280,7 +1388,47 @@ bool ubloxGPS::parseNavSVInfo( uint8_t chr )
           m_fix.satellites = chr;
           m_fix.valid.satellites = true;
 
-          #ifdef NMEAGPS_PARSE_SATELLITES
+          #if defined(NMEAGPS_SATELLITE_TABLE)
+            satellites.reported(); // even if there are none
+            break;
+        default:
+          // Each channel is collected in the first slot of the GSV
+          //   scratch area, and added to the table when it is complete.
+          if (chrCount >= 8) {
+            uint8_t i = (uint8_t) ((chrCount - 8) % 12);
+
+            switch (i) {
+              case 0:
+                _gsv.tracked = (chr != 255); // bit 0: tracked
+                break;
+              case 1: _gsv.id[0] = chr; break;
+              case 2:
+                if (chr & 0x01)
+                  _gsv.tracked |= 0x02;      // bit 1: svUsed
+                break;
+              case 4: _gsv.snr      [0] = chr; break;
+              case 5: _gsv.elevation[0] = chr; break;
+              case 6: _gsv.azimuth  [0] = chr; break;
+              case 7: _gsv.azimuth  [0] += (chr << 8); break;
+
+              case 11:
+                {
+                  uint8_t id     = _gsv.id[0];
+                  uint8_t system = svSystem( id );
+
+                  satellites.update
+                    ( system, id, 0,
+                      _gsv.elevation[0], _gsv.azimuth[0], _gsv.snr[0],
+                      (_gsv.tracked & 0x01) );
+                  if (_gsv.tracked & 0x02)
+                    satellites.used( system, id );
+                  sat_count = satellites.count;
+                }
+                break;
+            }
+          }
+
+          #elif defined(NMEAGPS_PARSE_SATELLITES)
             sat_count = 0;
             break;
         default:
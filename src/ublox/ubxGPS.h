@@ -59,7 +59,11 @@ public:
         reply_expected( false ),
         ack_expected( false ),
         m_device( device )
-      {};
+      {
+        #ifdef NMEAGPS_EXTENDED_STATS
+          ubx_statistics_init();
+        #endif
+      };
 
     // ublox binary UBX message type.
     enum ubx_msg_t {
@@ -85,6 +89,24 @@ public:
 
     ublox::msg_t & rx() { return m_rx_msg; }
 
+    //................................................................
+    //  Counts for each UBX message type (except ACK/NAK), in the order
+    //  they were first received.  Types after the first UBLOX_STATS_MSGS
+    //  are only counted in /statistics/.
+
+    #ifdef NMEAGPS_EXTENDED_STATS
+      struct ubx_statistics_t {
+        uint8_t  msg_class; // ublox::UBX_UNK if this entry is unused
+        uint8_t  msg_id;
+        uint32_t ok;
+        uint32_t errors;    // checksum errors
+      };
+
+      ubx_statistics_t ubx_statistics[ UBLOX_STATS_MSGS ];
+
+      void ubx_statistics_init();
+    #endif
+
     //................................................................
 
     bool enable_msg( ublox::msg_class_t msg_class, ublox::msg_id_t msg_id )
@@ -292,6 +314,10 @@ private:
     void rxBegin();
     bool rxEnd();
 
+    #ifdef NMEAGPS_EXTENDED_STATS
+      ubx_statistics_t *ubx_statistics_for( const ublox::msg_t & msg );
+    #endif
+
     static const uint8_t SYNC_1 = 0xB5;
     static const uint8_t SYNC_2 = 0x62;
 
@@ -305,6 +331,9 @@ private:
     bool parseNavTimeGPS( uint8_t chr );
     bool parseNavTimeUTC( uint8_t chr );
     bool parseNavSVInfo ( uint8_t chr );
+    #ifdef NMEAGPS_SATELLITE_TABLE
+      static uint8_t svSystem( uint8_t & id );
+    #endif
 
     bool parseHnrPvt( uint8_t chr );
 
@@ -51,13 +51,86 @@ bool ubloxNMEA::parseField(char chr)
 } // parseField
 
 //----------------------------
+//  Schemas for the PUBX messages.  The first field of each one is
+//    the message subtype.
 
-bool ubloxNMEA::parsePUBX_00( char chr )
+const uint8_t ubloxNMEA::pubx00_fields[] __PROGMEM =
+  {
+    FIELD_SKIP, FIELD_PUBX_SUBTYPE,
+    #ifdef NMEAGPS_PARSE_PUBX_00
+      FIELD_TIME,
+      FIELD_LAT, FIELD_NS, FIELD_LON, FIELD_EW,
+      FIELD_ALT,
+      FIELD_PUBX_FIX,
+      FIELD_PUBX_H_ACC,    // horizontal accuracy
+      FIELD_ALT_ERR,       // vertical accuracy
+      FIELD_SPEED_KPH,     // PUBX,00 provides speed in km/h!
+      FIELD_HEADING,
+      FIELD_VELOCITY_DOWN,
+      FIELD_SKIP,
+      FIELD_HDOP,
+      FIELD_VDOP,
+      FIELD_SKIP,
+      FIELD_SATELLITES
+    #endif
+  };
+
+const NMEAGPS::schema_t ubloxNMEA::pubx00_schema __PROGMEM =
+  { sizeof(pubx00_fields), pubx00_fields };
+
+#ifdef NMEAGPS_PARSE_PUBX_04
+  const uint8_t ubloxNMEA::pubx04_fields[] __PROGMEM =
+    {
+      FIELD_SKIP, FIELD_PUBX_SUBTYPE,
+      FIELD_TIME,
+      FIELD_DDMMYY
+    };
+
+  const NMEAGPS::schema_t ubloxNMEA::pubx04_schema __PROGMEM =
+    { sizeof(pubx04_fields), pubx04_fields };
+#endif
+
+//---------------------------------------------
+
+uint32_t ubloxNMEA::parsedFields() const
+{
+  if (nmeaMessage < (nmea_msg_t) PUBX_FIRST_MSG)
+    return NMEAGPS::parsedFields();
+
+  //  A PUBX_00 becomes a PUBX_04 in its first field, so parse the
+  //    fields of either one.
+  uint32_t fields = schemaMask( &pubx00_schema );
+  #ifdef NMEAGPS_PARSE_PUBX_04
+    fields |= schemaMask( &pubx04_schema );
+  #endif
+
+  return fields;
+
+} // parsedFields
+
+//---------------------------------------------
+
+const NMEAGPS::schema_t *ubloxNMEA::sentenceSchema() const
 {
-  bool ok = true;
+  switch (nmeaMessage) {
+    case PUBX_00: return &pubx00_schema;
+    #ifdef NMEAGPS_PARSE_PUBX_04
+      case PUBX_04: return &pubx04_schema;
+    #endif
+    default     : break;
+  }
+
+  return NMEAGPS::sentenceSchema();
+
+} // sentenceSchema
+
+//---------------------------------------------
 
-  switch (fieldIndex) {
-    case 1:
+bool ubloxNMEA::parsePUBX_00( char chr )
+{
+  bool    ok    = true;
+  switch (_converter) {
+    case FIELD_PUBX_SUBTYPE:
       // The first field is actually a message subtype
       if (chrCount == 0)
         ok = (chr == '0');
@@ -78,11 +151,8 @@ bool ubloxNMEA::parsePUBX_00( char chr )
       break;
 
     #ifdef NMEAGPS_PARSE_PUBX_00
-      case  2: return parseTime( chr );
-      PARSE_LOC(3);
-      case  7: return parseAlt( chr );
-      case  8: return parseFix( chr );
-      case  9: // use Horizontal accuracy for both lat and lon errors
+      case FIELD_PUBX_FIX: return parseFix( chr );
+      case FIELD_PUBX_H_ACC: // use Horizontal accuracy for both lat and lon errors
         #if defined(GPS_FIX_LAT_ERR)
           ok = parse_lat_err( chr );
           #if defined(GPS_FIX_LON_ERR)
@@ -99,26 +169,11 @@ bool ubloxNMEA::parsePUBX_00( char chr )
           ok = parse_lon_err( chr );
         #endif
         break;
-      case 10: return parse_alt_err( chr ); // vertical accuracy
-      case 11:
-        #ifdef GPS_FIX_SPEED
-          ok = parseSpeed( chr ); // PUBX,00 provides speed in km/h!
-
-          if ((chr == ',') && m_fix.valid.speed) {
-            uint32_t kph    = m_fix.spd.int32_000();
-            uint32_t nmiph  = (kph * 1000) / gps_fix::M_PER_NMI;
-            m_fix.spd.whole = nmiph / 1000;
-            m_fix.spd.frac  = (nmiph - m_fix.spd.whole*1000);
-            // Convert to Nautical Miles/Hour
-          }
-        #endif
-        break;
-      case 12: return parseHeading( chr );
-      case 13: return parseVelocityDown( chr );
-      case 15: return parseHDOP( chr );
-      case 16: return parseVDOP( chr );
-      case 18: return parseSatellites( chr );
+      case FIELD_VELOCITY_DOWN: return parseVelocityDown( chr );
     #endif
+
+    default:
+      return parseConverter( _converter, chr );
   }
 
   return ok;
@@ -130,14 +185,12 @@ bool ubloxNMEA::parsePUBX_00( char chr )
 bool ubloxNMEA::parsePUBX_04( char chr )
 {
   #ifdef NMEAGPS_PARSE_PUBX_04
-    switch (fieldIndex) {
-        case 2: return parseTime( chr );
-        case 3: return parseDDMMYY( chr );
-    }
+    return parseConverter( _converter, chr );
+  #else
+    (void) chr;
+    return true;
   #endif
 
-  return true;
-
 } // parsePUBX_04
 
 //---------------------------------------------
@@ -99,7 +99,24 @@ protected:
     bool parsePUBX_00( char chr );
     bool parsePUBX_04( char chr );
 
-    bool parseField( char chr );
+    bool     parseField( char chr );
+    uint32_t parsedFields() const;
+    const schema_t *sentenceSchema() const;
+
+    //  PUBX converters, in addition to the NMEAGPS converters
+    enum pubx_field_t {
+      FIELD_PUBX_SUBTYPE = FIELD_DERIVED,
+      FIELD_PUBX_FIX,
+      FIELD_PUBX_H_ACC,
+      FIELD_VELOCITY_DOWN
+    };
+
+    static const uint8_t  pubx00_fields[] __PROGMEM;
+    static const schema_t pubx00_schema   __PROGMEM;
+    #ifdef NMEAGPS_PARSE_PUBX_04
+      static const uint8_t  pubx04_fields[] __PROGMEM;
+      static const schema_t pubx04_schema   __PROGMEM;
+    #endif
 
     bool parseFix( char chr );
     bool parseVelocityDown( char chr );
@@ -44,6 +44,12 @@
   #warning UBX DOP message is enabled, but all gps_fix DOP members are disabled.
 #endif
 
+//--------------------------------------------------------------------
+// The number of UBX message types that have their own counters, if
+// NMEAGPS_EXTENDED_STATS is enabled in NMEAGPS_cfg.h.
+
+#define UBLOX_STATS_MSGS (8)
+
 //--------------------------------------------------------------------
 // Identify the last UBX message in an update interval.
 //    (There are two parts to a UBX message, the class and the ID.)
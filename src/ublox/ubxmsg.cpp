@@ -35,6 +35,14 @@ using namespace ublox;
 bool ublox::configNMEA( ubloxGPS &gps, NMEAGPS::nmea_msg_t msgType, uint8_t rate )
 {
   static const ubx_nmea_msg_t ubx[] __PROGMEM = {
+      #if defined(NMEAGPS_PARSE_DTM) | defined(NMEAGPS_RECOGNIZE_ALL)
+        UBX_GPDTM,
+      #endif
+        
+      #if defined(NMEAGPS_PARSE_GBS) | defined(NMEAGPS_RECOGNIZE_ALL)
+        UBX_GPGBS,
+      #endif
+        
       #if defined(NMEAGPS_PARSE_GGA) | defined(NMEAGPS_RECOGNIZE_ALL)
         UBX_GPGGA,
       #endif
@@ -43,6 +51,14 @@ bool ublox::configNMEA( ubloxGPS &gps, NMEAGPS::nmea_msg_t msgType, uint8_t rate
         UBX_GPGLL,
       #endif
         
+      #if defined(NMEAGPS_PARSE_GNS) | defined(NMEAGPS_RECOGNIZE_ALL)
+        UBX_GPGNS,
+      #endif
+        
+      #if defined(NMEAGPS_PARSE_GRS) | defined(NMEAGPS_RECOGNIZE_ALL)
+        UBX_GPGRS,
+      #endif
+        
       #if defined(NMEAGPS_PARSE_GSA) | defined(NMEAGPS_RECOGNIZE_ALL)
         UBX_GPGSA,
       #endif
@@ -55,6 +71,10 @@ bool ublox::configNMEA( ubloxGPS &gps, NMEAGPS::nmea_msg_t msgType, uint8_t rate
         UBX_GPGSV,
       #endif
         
+      #if defined(NMEAGPS_PARSE_HDT) | defined(NMEAGPS_RECOGNIZE_ALL)
+        UBX_GPNONE,
+      #endif
+        
       #if defined(NMEAGPS_PARSE_RMC) | defined(NMEAGPS_RECOGNIZE_ALL)
         UBX_GPRMC,
       #endif
@@ -73,9 +93,11 @@ bool ublox::configNMEA( ubloxGPS &gps, NMEAGPS::nmea_msg_t msgType, uint8_t rate
   if (msg_index >= sizeof(ubx)/sizeof(ubx[0]))
     return false;
 
-  msg_id_t msg_id = (msg_id_t) pgm_read_byte( &ubx[msg_index] );
+  uint8_t msg_id = pgm_read_byte( &ubx[msg_index] );
+  if (msg_id == UBX_GPNONE)
+    return false;
 
-  return gps.send( cfg_msg_t( UBX_NMEA, msg_id, rate ) );
+  return gps.send( cfg_msg_t( UBX_NMEA, (msg_id_t) msg_id, rate ) );
 }
 
 #endif // UBX messages defined
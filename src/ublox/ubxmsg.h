@@ -106,8 +106,13 @@ namespace ublox {
         UBX_GPGSV = 0x03,
         UBX_GPRMC = 0x04,
         UBX_GPVTG = 0x05,
+        UBX_GPGRS = 0x06,
         UBX_GPGST = 0x07,
-        UBX_GPZDA = 0x08
+        UBX_GPZDA = 0x08,
+        UBX_GPGBS = 0x09,
+        UBX_GPDTM = 0x0A,
+        UBX_GPGNS = 0x0D,
+        UBX_GPNONE = 0xFF // not available from ublox devices (e.g., HDT)
     } __attribute__((packed));
 
     struct cfg_msg_t : msg_t {